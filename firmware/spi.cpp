@@ -8,20 +8,73 @@
  * published by the Free Software Foundation.
  */
 
+#ifdef SPI_EMULATION
+#include "spi.h"
+#else
 #include "pins_arduino.h"
 #include "SPI.h"
+#endif
 
 SPIClass SPI;
 
+const uint8_t SPIBitReverseTable[256] PROGMEM = {
+  0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
+  0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8, 0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
+  0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
+  0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
+  0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2, 0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
+  0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
+  0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6, 0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
+  0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE, 0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
+  0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1, 0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
+  0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9, 0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
+  0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5, 0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
+  0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED, 0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
+  0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3, 0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
+  0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB, 0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
+  0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7, 0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
+  0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF, 0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF
+};
+
+// Divider codes from fastest to slowest.
+static const uint8_t clockSteps[] = {
+  SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+  SPI_CLOCK_DIV32, SPI_CLOCK_DIV64, SPI_CLOCK_DIV128
+};
+#define SPI_CLOCK_STEPS (sizeof(clockSteps) / sizeof(clockSteps[0]))
+
+SPIIdleTransferFunc SPIClass::idleTransfer = NULL;
+
+// Calibrated for a 16 MHz AVR, where taking the SPI interrupt costs
+// about 60 cycles per byte: sleeping only wins from DIV32 upwards.
+uint8_t SPIClass::idleThreshold[8] = {
+  0,   // SPI_CLOCK_DIV4
+  0,   // SPI_CLOCK_DIV16
+  2,   // SPI_CLOCK_DIV64
+  1,   // SPI_CLOCK_DIV128
+  0,   // SPI_CLOCK_DIV2
+  0,   // SPI_CLOCK_DIV8
+  8,   // SPI_CLOCK_DIV32
+  2    // SPI_CLOCK_DIV64 (SPI2X)
+};
+
+uint8_t SPIClass::interruptMode = 0;
+uint8_t SPIClass::interruptMask = 0;
+uint8_t SPIClass::interruptSave = 0;
+volatile uint8_t SPIClass::transactionOpen = 0;
+volatile uint8_t SPIClass::deferHead = 0;
+volatile uint8_t SPIClass::deferTail = 0;
+SPIClass::DeferredJob SPIClass::deferQueue[SPI_DEFER_QUEUE_SIZE];
+
 void SPIClass::begin() {
 
   // Set SS to high so a connected chip will be "deselected" by default
-  digitalWrite(SS, HIGH);
+  spiPinHigh(SS);
 
   // When the SS pin is set as OUTPUT, it can be used as
   // a general purpose output port (it doesn't influence
   // SPI operations).
-  pinMode(SS, OUTPUT);
+  spiPinOutput(SS);
 
   // Warning: if the SS pin ever becomes a LOW INPUT then SPI
   // automatically switches to Slave, so the data direction of
@@ -35,10 +88,19 @@ void SPIClass::begin() {
   // clocking in a single bit since the lines go directly
   // from "input" to SPI control.  
   // http://code.google.com/p/arduino/issues/detail?id=888
-  pinMode(SCK, OUTPUT);
-  pinMode(MOSI, OUTPUT);
+  spiPinPeripheral(SCK);
+  spiPinPeripheral(MOSI);
 }
 
+void SPIClass::beginSlave() {
+  spiPinInput(SS);
+  spiPinInput(SCK);
+  spiPinInput(MOSI);
+  // MISO is only an output in slave mode if we make it one.
+  spiPinOutput(MISO);
+  SPCR &= ~_BV(MSTR);
+  SPCR |= _BV(SPE);
+}
 
 void SPIClass::end() {
   SPCR &= ~_BV(SPE);
@@ -64,3 +126,275 @@ void SPIClass::setClockDivider(uint8_t rate)
   SPSR = (SPSR & ~SPI_2XCLOCK_MASK) | ((rate >> 2) & SPI_2XCLOCK_MASK);
 }
 
+void SPIClass::transfer(const void *txBuf, void *rxBuf, size_t count, byte fill)
+{
+  const byte *out = (const byte *)txBuf;
+  byte *in = (byte *)rxBuf;
+  if (count == 0)
+    return;
+
+  if (idleTransfer) {
+    uint8_t threshold = idleThreshold[((SPSR & SPI_2XCLOCK_MASK) << 2) |
+                                      (SPCR & SPI_CLOCK_MASK)];
+    if (threshold && count >= threshold &&
+        idleTransfer(txBuf, rxBuf, count, fill))
+      return;
+  }
+
+  // Keep the shifter busy: the next outgoing byte is fetched while the
+  // current one is on the wire, so only the SPDR swap happens between
+  // SPIF and the next write.
+  SPDR = out ? *out++ : fill;
+  while (--count) {
+    byte next = out ? *out++ : fill;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    byte received = SPDR;
+    SPDR = next;
+    if (in)
+      *in++ = received;
+  }
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  byte received = SPDR;
+  if (in)
+    *in = received;
+}
+
+void SPIClass::transferReversed(const void *txBuf, void *rxBuf, size_t count, byte fill)
+{
+  const byte *out = (const byte *)txBuf;
+  byte *in = (byte *)rxBuf;
+  if (count == 0)
+    return;
+
+  // Same pipelining as transfer(): the table lookup for the next byte
+  // is done while the current one shifts out.
+  SPDR = out ? reverseBits(*out++) : fill;
+  while (--count) {
+    byte next = out ? reverseBits(*out++) : fill;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    byte received = SPDR;
+    SPDR = next;
+    if (in)
+      *in++ = reverseBits(received);
+  }
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  byte received = SPDR;
+  if (in)
+    *in = reverseBits(received);
+}
+
+uint8_t SPIClass::tryTransfer(const void *txBuf, void *rxBuf, size_t count,
+                              uint16_t timeout)
+{
+  const byte *out = (const byte *)txBuf;
+  byte *in = (byte *)rxBuf;
+  byte received = 0;
+
+  while (count--) {
+    uint8_t status = tryTransfer(out ? *out++ : 0x00, &received, timeout);
+    if (status != SPI_OK)
+      return status;
+    if (in)
+      *in++ = received;
+  }
+  return SPI_OK;
+}
+
+// Slow path of tryTransfer(): works out why SPIF never showed up, or
+// why the transfer completed in slave mode, and repairs what it can.
+uint8_t SPIClass::recover()
+{
+  uint8_t spcr = SPCR;
+
+  if (!(spcr & _BV(SPE)))
+    return SPI_ERR_DISABLED;
+
+  if (!(spcr & _BV(MSTR))) {
+    // Clear the SPIF/WCOL left behind by the fault, then redo the
+    // relevant part of begin(): SS back to a high output, master mode on.
+    (void)SPSR;
+    (void)SPDR;
+    spiPinHigh(SS);
+    spiPinOutput(SS);
+    SPCR |= _BV(MSTR);
+    return SPI_ERR_MODE_FAULT;
+  }
+
+  // The byte is still shifting: let it finish and drop it, or the next
+  // write collides with it and reads its stale data. A byte at DIV128
+  // is done well within the default poll budget.
+  for (uint16_t wait = SPI_DEFAULT_TIMEOUT; wait && !(SPSR & _BV(SPIF)); wait--)
+    ;
+  (void)SPDR;
+  return SPI_ERR_TIMEOUT;
+}
+
+void SPIClass::disableIdleSleep()
+{
+  idleTransfer = NULL;
+}
+
+void SPIClass::setIdleSleepThreshold(uint8_t clockDivider, uint8_t minCount)
+{
+  idleThreshold[clockDivider & 0x07] = minCount;
+}
+
+static uint8_t clockStep(uint8_t rate)
+{
+  // SPR 11 with SPI2X is DIV64 again, the same step as SPR 10.
+  if (rate == 0x07)
+    rate = SPI_CLOCK_DIV64;
+  for (uint8_t i = 0; i < SPI_CLOCK_STEPS; i++) {
+    if (clockSteps[i] == rate)
+      return i;
+  }
+  return SPI_CLOCK_STEPS - 1;
+}
+
+bool SPISettings::slowDown()
+{
+  uint8_t step = clockStep(clockDivider());
+  if (step >= SPI_CLOCK_STEPS - 1)
+    return false;
+  setClockDivider(clockSteps[step + 1]);
+  return true;
+}
+
+bool SPISettings::speedUp()
+{
+  uint8_t step = clockStep(clockDivider());
+  if (step == 0)
+    return false;
+  setClockDivider(clockSteps[step - 1]);
+  return true;
+}
+
+bool SPIClass::tuneClock(SPISettings &settings, SPIProbeFunc probe,
+                         void *context, uint8_t trials)
+{
+  SPISettings trial = settings;
+  bool found = false;
+
+  trial.setClockDivider(SPI_CLOCK_DIV128);
+  for (;;) {
+    bool passed = true;
+    beginTransaction(trial);
+    for (uint8_t i = 0; i < trials && passed; i++)
+      passed = probe(context);
+    endTransaction();
+
+    if (!passed)
+      break;
+    settings = trial;
+    found = true;
+    if (!trial.speedUp())
+      break;
+  }
+  return found;
+}
+
+bool SPIClass::registerProbe(void *context)
+{
+  const SPIRegisterProbe *probe = (const SPIRegisterProbe *)context;
+  bool match = true;
+
+  spiPinLow(probe->csPin);
+  transfer(probe->command, NULL, probe->commandLength);
+  for (uint8_t i = 0; i < probe->expectedLength; i++) {
+    if (transfer(0x00) != probe->expected[i])
+      match = false;
+  }
+  spiPinHigh(probe->csPin);
+  return match;
+}
+
+void SPIClass::usingInterrupt(uint8_t interruptNumber)
+{
+  uint8_t mask = 0;
+  uint8_t sreg = SREG;
+  noInterrupts();
+#ifdef EIMSK
+  // External interrupts can be masked individually; anything else
+  // forces transactions to fall back to disabling interrupts globally.
+  if (interruptNumber < 8)
+    mask = _BV(interruptNumber);
+#else
+  (void)interruptNumber;
+#endif
+  if (mask) {
+    interruptMask |= mask;
+    if (!interruptMode)
+      interruptMode = 1;
+  } else {
+    interruptMode = 2;
+  }
+  SREG = sreg;
+}
+
+void SPIClass::beginTransaction()
+{
+  if (interruptMode > 0) {
+    uint8_t sreg = SREG;
+    noInterrupts();
+#ifdef EIMSK
+    if (interruptMode == 1) {
+      interruptSave = EIMSK;
+      EIMSK &= ~interruptMask;
+      SREG = sreg;
+    } else
+#endif
+    {
+      interruptSave = sreg;
+    }
+  }
+  transactionOpen = 1;
+}
+
+void SPIClass::endTransaction()
+{
+  // Run work deferred by interrupt handlers while the bus is still ours.
+  // A handler may queue more after the last check, so look again once
+  // ownership has been dropped and take the bus back if it did.
+  for (;;) {
+    while (deferTail != deferHead) {
+      DeferredJob job = deferQueue[deferTail & (SPI_DEFER_QUEUE_SIZE - 1)];
+      deferTail = deferTail + 1;
+      job.func(job.arg);
+    }
+    transactionOpen = 0;
+    if (deferTail == deferHead)
+      break;
+    transactionOpen = 1;
+  }
+
+  if (interruptMode > 0) {
+#ifdef EIMSK
+    if (interruptMode == 1) {
+      uint8_t sreg = SREG;
+      noInterrupts();
+      EIMSK = interruptSave;
+      SREG = sreg;
+    } else
+#endif
+    {
+      SREG = interruptSave;
+    }
+  }
+}
+
+// Called from interrupt context only. Handlers don't nest, so the queue
+// has a single producer and a single consumer and needs no lock.
+bool SPIClass::defer(SPIDeferredFunc func, void *arg)
+{
+  uint8_t head = deferHead;
+  if ((uint8_t)(head - deferTail) >= SPI_DEFER_QUEUE_SIZE)
+    return false;
+  deferQueue[head & (SPI_DEFER_QUEUE_SIZE - 1)].func = func;
+  deferQueue[head & (SPI_DEFER_QUEUE_SIZE - 1)].arg = arg;
+  deferHead = head + 1;
+  return true;
+}
@@ -11,9 +11,15 @@
 #ifndef _SPI_H_INCLUDED
 #define _SPI_H_INCLUDED
 
+#ifdef SPI_EMULATION
+#include "spi_emu.h"
+#else
 #include <stdio.h>
 #include <Arduino.h>
 #include <avr/pgmspace.h>
+#endif
+
+#include "spi_pins.h"
 
 #define SPI_CLOCK_DIV4 0x00
 #define SPI_CLOCK_DIV16 0x01
@@ -33,25 +39,220 @@
 #define SPI_CLOCK_MASK 0x03  // SPR1 = bit 1, SPR0 = bit 0 on SPCR
 #define SPI_2XCLOCK_MASK 0x01  // SPI2X = bit 0 on SPSR
 
+// Number of jobs interrupt handlers can queue while the bus is owned by
+// an open transaction. Must be a power of two.
+#ifndef SPI_DEFER_QUEUE_SIZE
+#define SPI_DEFER_QUEUE_SIZE 4
+#endif
+
+typedef void (*SPIDeferredFunc)(void *arg);
+
+// Interrupt-driven replacement for the polled block transfer. Returns
+// false if it cannot run, in which case transfer() polls as usual.
+typedef bool (*SPIIdleTransferFunc)(const void *txBuf, void *rxBuf,
+                                    size_t count, byte fill);
+
+// Link check used by SPIClass::tuneClock(): runs one exchange with the
+// device and returns true if the answer was correct.
+typedef bool (*SPIProbeFunc)(void *context);
+
+// Ready-made probe for SPIClass::registerProbe(): sends command, then
+// compares the bytes that follow against expected.
+struct SPIRegisterProbe {
+  uint8_t csPin;
+  const byte *command;
+  uint8_t commandLength;
+  const byte *expected;
+  uint8_t expectedLength;
+};
+
+extern const uint8_t SPIBitReverseTable[256] PROGMEM;
+
+// Status codes returned by the bounded-wait transfers.
+#define SPI_OK 0
+#define SPI_ERR_TIMEOUT 1     // SPIF not set within the poll budget
+#define SPI_ERR_DISABLED 2    // SPE is cleared, e.g. after end()
+#define SPI_ERR_MODE_FAULT 3  // SS went low and cleared MSTR; master mode restored
+#define SPI_ERR_COLLISION 4   // SPDR written while a byte was still shifting
+
+// Default poll budget: a byte at SPI_CLOCK_DIV128 is 1024 cycles,
+// comfortably below 4096 polls of SPSR.
+#ifndef SPI_DEFAULT_TIMEOUT
+#define SPI_DEFAULT_TIMEOUT 4096
+#endif
+
+// Bus configuration for one device, packed as the SPCR/SPSR values
+// that select it, so switching devices is two register stores.
+class SPISettings {
+public:
+  SPISettings()
+    : spcr(_BV(SPE) | _BV(MSTR)), spsr(0) {}
+  SPISettings(uint8_t clockDivider, uint8_t bitOrder, uint8_t dataMode)
+    : spcr(_BV(SPE) | _BV(MSTR) |
+           (bitOrder == LSBFIRST ? _BV(DORD) : 0) |
+           (dataMode & SPI_MODE_MASK) |
+           (clockDivider & SPI_CLOCK_MASK)),
+      spsr((clockDivider >> 2) & SPI_2XCLOCK_MASK) {}
+
+  bool operator==(const SPISettings &other) const {
+    return spcr == other.spcr && spsr == other.spsr;
+  }
+  bool operator!=(const SPISettings &other) const {
+    return !(*this == other);
+  }
+
+  uint8_t clockDivider() const {
+    return ((spsr & SPI_2XCLOCK_MASK) << 2) | (spcr & SPI_CLOCK_MASK);
+  }
+  void setClockDivider(uint8_t rate) {
+    spcr = (spcr & ~SPI_CLOCK_MASK) | (rate & SPI_CLOCK_MASK);
+    spsr = (rate >> 2) & SPI_2XCLOCK_MASK;
+  }
+  // Moves one divider step slower or faster. Returns false at the end
+  // of the range, leaving the settings unchanged.
+  bool slowDown();
+  bool speedUp();
+
+  uint8_t spcr;
+  uint8_t spsr;
+};
+
 class SPIClass {
 public:
   inline static byte transfer(byte _data);
+  // Full-duplex block transfer. Either buffer may be NULL: with no
+  // txBuf the fill byte is sent, with no rxBuf the input is discarded.
+  static void transfer(const void *txBuf, void *rxBuf, size_t count, byte fill = 0x00);
+
+  // Block transfer with every byte bit-reversed in software, for
+  // talking LSB-first to a device while DORD is set up for MSB-first
+  // (or the other way around). The fill byte is sent as is.
+  static void transferReversed(const void *txBuf, void *rxBuf, size_t count, byte fill = 0x00);
+  inline static byte reverseBits(byte value);
+
+  // Send-only transfers that convert on the fly: RGB888 pixels as
+  // big-endian RGB565, native int16 samples as big-endian (see
+  // spi_convert.h for the buffer-at-a-time kernels).
+  static void transferRGB565(const void *rgb888, size_t pixels);
+  static void transferInt16BE(const int16_t *samples, size_t count);
+
+  // Send-only block transfer. At SPI_CLOCK_DIV2 and DIV4 on AVR it uses
+  // a cycle-counted loop that writes SPDR on a fixed schedule instead
+  // of polling SPIF; other dividers go through transfer(). Returns
+  // SPI_ERR_COLLISION if the schedule was ever too tight for the
+  // shifter, which means the device saw corrupted data.
+  static uint8_t send(const void *buf, size_t count);
+
+  // Bounded-wait variants of transfer(). Each byte may poll SPSR at most
+  // timeout times; on failure an SPI_ERR_* code is returned. A timeout
+  // of 0 fails with SPI_ERR_TIMEOUT without touching the bus. After a
+  // timeout the late byte has been drained, so a retry starts clean.
+  inline static uint8_t tryTransfer(byte _data, byte *received,
+                                    uint16_t timeout = SPI_DEFAULT_TIMEOUT);
+  static uint8_t tryTransfer(const void *txBuf, void *rxBuf, size_t count,
+                             uint16_t timeout = SPI_DEFAULT_TIMEOUT);
 
   // SPI Configuration methods
 
   inline static void attachInterrupt();
+  // Runs handler from the SPI interrupt. The sketch must contain
+  // SPI_INTERRUPT_VECTOR once for it to be called.
+  static void attachInterrupt(void (*handler)(void));
+  static void handleInterrupt();
   inline static void detachInterrupt(); // Default
 
   static void begin(); // Default
+  // Slave mode: SS, SCK and MOSI are inputs driven by the remote master.
+  static void beginSlave();
+  // Pin change interrupt on SS, for slave-mode receivers that frame on
+  // it. The sketch routes the vector to them (SPI_SLAVE_SELECT_VECTOR,
+  // SPI_LINK_SELECT_VECTOR).
+  static void enableSelectInterrupt(bool enable);
   static void end();
 
+  // Power the peripheral down between bursts without losing its setup:
+  // suspend() saves SPCR, SPSR and the SS/SCK/MOSI pin state, parks SCK
+  // at its idle level and gates the SPI clock; resume() restores all of
+  // it. Neither may be called inside a transaction.
+  static void suspend();
+  static void resume();
+
   static void setBitOrder(uint8_t);
   static void setDataMode(uint8_t);
   static void setClockDivider(uint8_t);
+
+  // Sleep in idle mode instead of polling SPIF during block transfers
+  // long enough to pay for the interrupt per byte. The threshold table,
+  // indexed by SPI_CLOCK_DIVn, holds the smallest count worth sleeping
+  // for; 0 means always poll at that divider. Needs
+  // SPI_INTERRUPT_VECTOR in the sketch.
+  static void enableIdleSleep();
+  static void disableIdleSleep();
+  static void setIdleSleepThreshold(uint8_t clockDivider, uint8_t minCount);
+
+  // Steps the divider of settings up from the slowest rate, running the
+  // probe trials times at each step, and leaves the fastest rate that
+  // never failed in settings. Returns false if even the slowest failed,
+  // leaving settings as they were.
+  static bool tuneClock(SPISettings &settings, SPIProbeFunc probe,
+                        void *context, uint8_t trials = 8);
+  static bool registerProbe(void *probe);
+
+  // Bus ownership. Handlers registered with usingInterrupt() are masked
+  // for the duration of a transaction; other handlers should check
+  // inTransaction() and hand their work to defer(), which is run at
+  // endTransaction() while the bus is still owned.
+  static void usingInterrupt(uint8_t interruptNumber);
+  static void beginTransaction();
+  inline static void beginTransaction(SPISettings settings);
+  inline static void applySettings(SPISettings settings);
+  static void endTransaction();
+  inline static bool inTransaction();
+  static bool defer(SPIDeferredFunc func, void *arg);
+
+private:
+  static uint8_t recover();
+
+  static uint8_t suspendedSpcr;
+  static uint8_t suspendedSpsr;
+  static uint8_t suspendedDir;
+  static uint8_t suspendedOut;
+
+  static SPIIdleTransferFunc idleTransfer;
+  static uint8_t idleThreshold[8];
+
+  struct DeferredJob {
+    SPIDeferredFunc func;
+    void *arg;
+  };
+
+  static uint8_t interruptMode; // 0=none, 1=mask EIMSK bits, 2=global
+  static uint8_t interruptMask;
+  static uint8_t interruptSave;
+  static volatile uint8_t transactionOpen;
+  static volatile uint8_t deferHead;
+  static volatile uint8_t deferTail;
+  static DeferredJob deferQueue[SPI_DEFER_QUEUE_SIZE];
 };
 
 extern SPIClass SPI;
 
+// Compiler barrier for rings shared with an interrupt handler: slot
+// contents are stored before the index that publishes them, and read
+// after the index that says they are there.
+#define SPI_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+// Defines the SPI vector and routes it to the handler attached with
+// SPIClass::attachInterrupt(handler). Put it once at file scope in a
+// sketch that uses SPIAsync, idle sleep, SPILinkSlave or SPISlave:
+//
+//   SPI_INTERRUPT_VECTOR
+#ifdef SPI_STC_vect
+#define SPI_INTERRUPT_VECTOR ISR(SPI_STC_vect) { SPIClass::handleInterrupt(); }
+#else
+#define SPI_INTERRUPT_VECTOR
+#endif
+
 byte SPIClass::transfer(byte _data) {
   SPDR = _data;
   while (!(SPSR & _BV(SPIF)))
@@ -59,6 +260,31 @@ byte SPIClass::transfer(byte _data) {
   return SPDR;
 }
 
+uint8_t SPIClass::tryTransfer(byte _data, byte *received, uint16_t timeout) {
+  if (timeout == 0)
+    return SPI_ERR_TIMEOUT;
+  SPDR = _data;
+  uint8_t status;
+  while (!((status = SPSR) & _BV(SPIF)) && --timeout)
+    ;
+  // A mode fault also sets SPIF, so MSTR is checked on the way out.
+  if (!timeout || !(SPCR & _BV(MSTR)))
+    return recover();
+  // WCOL means _data was dropped and SPDR holds an older byte.
+  *received = SPDR;
+  return (status & _BV(WCOL)) ? SPI_ERR_COLLISION : SPI_OK;
+}
+
+byte SPIClass::reverseBits(byte value) {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+  uint32_t result;
+  __asm__("rbit %0, %1" : "=r" (result) : "r" ((uint32_t)value));
+  return result >> 24;
+#else
+  return pgm_read_byte(&SPIBitReverseTable[value]);
+#endif
+}
+
 void SPIClass::attachInterrupt() {
   SPCR |= _BV(SPIE);
 }
@@ -67,4 +293,19 @@ void SPIClass::detachInterrupt() {
   SPCR &= ~_BV(SPIE);
 }
 
+void SPIClass::beginTransaction(SPISettings settings) {
+  beginTransaction();
+  applySettings(settings);
+}
+
+// SPIE belongs to whoever attached an interrupt, not to the settings.
+void SPIClass::applySettings(SPISettings settings) {
+  SPCR = (SPCR & _BV(SPIE)) | settings.spcr;
+  SPSR = (SPSR & ~SPI_2XCLOCK_MASK) | settings.spsr;
+}
+
+bool SPIClass::inTransaction() {
+  return transactionOpen;
+}
+
 #endif
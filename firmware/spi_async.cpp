@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_async.h"
+
+const byte *SPIAsync::txPtr;
+byte *SPIAsync::rxPtr;
+byte SPIAsync::fillByte;
+size_t SPIAsync::remaining;
+SPITask *SPIAsync::waiter;
+volatile uint8_t SPIAsync::active = 0;
+
+SPITask *SPIScheduler::tasks[SPI_MAX_TASKS];
+
+bool SPIAsync::start(const void *txBuf, void *rxBuf, size_t count,
+                     byte fill, SPITask *task)
+{
+  if (active)
+    return false;
+  if (count == 0)
+    return true;
+#if defined(__AVR__) || defined(SPI_EMULATION)
+  // No completion interrupt would ever run.
+  if (!(SREG & _BV(SREG_I))) {
+    SPI.transfer(txBuf, rxBuf, count, fill);
+    return true;
+  }
+#endif
+
+  txPtr = (const byte *)txBuf;
+  rxPtr = (byte *)rxBuf;
+  fillByte = fill;
+  remaining = count;
+  waiter = task;
+  if (task)
+    task->blocked = 1;
+  active = 1;
+
+  SPIClass::attachInterrupt(onInterrupt);
+  SPDR = txPtr ? *txPtr++ : fillByte;
+  return true;
+}
+
+void SPIAsync::onInterrupt()
+{
+  byte received = SPDR;
+  if (rxPtr)
+    *rxPtr++ = received;
+  if (--remaining) {
+    SPDR = txPtr ? *txPtr++ : fillByte;
+    return;
+  }
+
+  SPIClass::detachInterrupt();
+  if (waiter) {
+    waiter->blocked = 0;
+    waiter = NULL;
+  }
+  active = 0;
+}
+
+bool SPIScheduler::add(SPITask *task, SPITaskFunc func, void *context)
+{
+  for (uint8_t i = 0; i < SPI_MAX_TASKS; i++) {
+    if (!tasks[i]) {
+      task->func = func;
+      task->context = context;
+      task->resume = 0;
+      task->blocked = 0;
+      tasks[i] = task;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SPIScheduler::run()
+{
+  bool ran = false;
+  for (uint8_t i = 0; i < SPI_MAX_TASKS; i++) {
+    SPITask *task = tasks[i];
+    if (!task || task->blocked)
+      continue;
+    ran = true;
+    if (task->func(task) == SPI_TASK_DONE)
+      tasks[i] = NULL;
+  }
+  return ran;
+}
+
+bool SPIScheduler::runnable()
+{
+  for (uint8_t i = 0; i < SPI_MAX_TASKS; i++) {
+    SPITask *task = tasks[i];
+    if (task && !task->blocked)
+      return true;
+  }
+  return false;
+}
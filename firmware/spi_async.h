@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_ASYNC_H_INCLUDED
+#define _SPI_ASYNC_H_INCLUDED
+
+#include "spi.h"
+
+#ifndef SPI_MAX_TASKS
+#define SPI_MAX_TASKS 4
+#endif
+
+#define SPI_TASK_WAITING 0
+#define SPI_TASK_DONE 1
+
+struct SPITask;
+typedef uint8_t (*SPITaskFunc)(SPITask *task);
+
+struct SPITask {
+  SPITaskFunc func;
+  void *context;
+  uint16_t resume;
+  volatile uint8_t blocked;
+};
+
+// Interrupt-driven transfer: each SPIF interrupt stores the received
+// byte and loads the next one, so the CPU is free between bytes. The
+// sketch needs SPI_INTERRUPT_VECTOR.
+class SPIAsync {
+public:
+  // Returns false if a transfer is already running. The waiting task,
+  // if given, stays blocked until the completion interrupt. With
+  // interrupts disabled, e.g. inside a transaction after
+  // usingInterrupt() fell back to global masking, the transfer is done
+  // by polling before start() returns and the task is not blocked.
+  static bool start(const void *txBuf, void *rxBuf, size_t count,
+                    byte fill = 0x00, SPITask *waiter = NULL);
+  inline static bool busy() { return active; }
+
+private:
+  static void onInterrupt();
+
+  static const byte *txPtr;
+  static byte *rxPtr;
+  static byte fillByte;
+  static size_t remaining;
+  static SPITask *waiter;
+  static volatile uint8_t active;
+};
+
+// Round-robin scheduler for cooperative tasks. Tasks blocked on a
+// transfer are skipped until the interrupt handler releases them.
+class SPIScheduler {
+public:
+  static bool add(SPITask *task, SPITaskFunc func, void *context = NULL);
+  // Runs every runnable task once. Returns false if nothing could run,
+  // i.e. all tasks are waiting on the bus.
+  static bool run();
+  // Whether any task could run. A completion interrupt can unblock a
+  // task at any time, so check this with interrupts off right before
+  // sleeping:
+  //
+  //   if (!SPIScheduler::run()) {
+  //     set_sleep_mode(SLEEP_MODE_IDLE);
+  //     noInterrupts();
+  //     if (!SPIScheduler::runnable()) {
+  //       sleep_enable();
+  //       interrupts();  // SEI: the next instruction runs before any interrupt
+  //       sleep_cpu();
+  //       sleep_disable();
+  //     }
+  //     interrupts();
+  //   }
+  static bool runnable();
+
+private:
+  static SPITask *tasks[SPI_MAX_TASKS];
+};
+
+// Task bodies are written linearly with these macros. As with any
+// stackless coroutine, locals do not survive an await: keep state in
+// the task context.
+//
+//   uint8_t readSensor(SPITask *t) {
+//     Sensor *s = (Sensor *)t->context;
+//     SPI_TASK_BEGIN(t);
+//     SPI_AWAIT_TRANSACTION(t);
+//     digitalWrite(s->cs, LOW);
+//     SPI_AWAIT_TRANSFER(t, s->cmd, s->reply, sizeof(s->reply));
+//     digitalWrite(s->cs, HIGH);
+//     SPI.endTransaction();
+//     SPI_TASK_END(t);
+//   }
+#define SPI_TASK_BEGIN(task) switch ((task)->resume) { case 0:
+#define SPI_TASK_END(task) } (task)->resume = 0; return SPI_TASK_DONE
+
+// The case label sits in a dead block so that reaching it from the
+// line above is not a switch fall-through to the compiler.
+#define SPI_AWAIT_AT_(task, label, cond) \
+  do { \
+    (task)->resume = (label); \
+    if (0) { \
+    case (label):; \
+    } \
+    if (!(cond)) \
+      return SPI_TASK_WAITING; \
+  } while (0)
+
+#define SPI_AWAIT(task, cond) SPI_AWAIT_AT_(task, 3 * __LINE__, cond)
+
+#define SPI_AWAIT_TRANSFER(task, txBuf, rxBuf, count) \
+  do { \
+    SPI_AWAIT_AT_(task, 3 * __LINE__, \
+                  SPIAsync::start(txBuf, rxBuf, count, 0x00, task)); \
+    SPI_AWAIT_AT_(task, 3 * __LINE__ + 1, !(task)->blocked); \
+  } while (0)
+
+#define SPI_AWAIT_TRANSACTION(task) \
+  do { \
+    SPI_AWAIT_AT_(task, 3 * __LINE__ + 2, !SPI.inTransaction()); \
+    SPI.beginTransaction(); \
+  } while (0)
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_command.h"
+
+// Record layout: opcode byte followed by its operands.
+#define OP_SELECT 0x01    // pin, spcr, spsr
+#define OP_DESELECT 0x02  //
+#define OP_WRITE 0x03     // length (1..255), data
+#define OP_DELAY 0x04     // microseconds, little endian
+
+SPICommandBuffer::SPICommandBuffer(byte *buf, size_t size)
+  : arena(buf), capacity(size), length(0), lastWrite(size), overflow(false)
+{
+}
+
+byte *SPICommandBuffer::reserve(size_t n)
+{
+  if (overflow || capacity - length < n) {
+    overflow = true;
+    return NULL;
+  }
+  byte *record = arena + length;
+  length += n;
+  return record;
+}
+
+bool SPICommandBuffer::select(uint8_t csPin, SPISettings settings)
+{
+  byte *record = reserve(4);
+  if (!record)
+    return false;
+  record[0] = OP_SELECT;
+  record[1] = csPin;
+  record[2] = settings.spcr;
+  record[3] = settings.spsr;
+  return true;
+}
+
+bool SPICommandBuffer::deselect()
+{
+  byte *record = reserve(1);
+  if (!record)
+    return false;
+  record[0] = OP_DESELECT;
+  return true;
+}
+
+bool SPICommandBuffer::write(byte value)
+{
+  return write(&value, 1);
+}
+
+bool SPICommandBuffer::write(const void *data, size_t len)
+{
+  const byte *in = (const byte *)data;
+
+  while (len) {
+    // Consecutive writes are merged into the previous record.
+    size_t chunk;
+    if (lastWrite < length && lastWrite + 2 + arena[lastWrite + 1] == length &&
+        arena[lastWrite + 1] < 255) {
+      chunk = 255 - arena[lastWrite + 1];
+      if (chunk > len)
+        chunk = len;
+      byte *tail = reserve(chunk);
+      if (!tail)
+        return false;
+      memcpy(tail, in, chunk);
+      arena[lastWrite + 1] += chunk;
+    } else {
+      chunk = len > 255 ? 255 : len;
+      byte *record = reserve(2 + chunk);
+      if (!record)
+        return false;
+      lastWrite = record - arena;
+      record[0] = OP_WRITE;
+      record[1] = chunk;
+      memcpy(record + 2, in, chunk);
+    }
+    in += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
+bool SPICommandBuffer::delayMicroseconds(uint16_t us)
+{
+  byte *record = reserve(3);
+  if (!record)
+    return false;
+  record[0] = OP_DELAY;
+  record[1] = us;
+  record[2] = us >> 8;
+  return true;
+}
+
+bool SPICommandBuffer::replay() const
+{
+  if (overflow)
+    return false;
+
+  const byte *pc = arena;
+  const byte *stop = arena + length;
+  uint8_t selected = 0xFF;
+  SPISettings current;
+  bool configured = false;
+
+  SPI.beginTransaction();
+  while (pc < stop) {
+    switch (*pc) {
+    case OP_SELECT: {
+      SPISettings wanted;
+      wanted.spcr = pc[2];
+      wanted.spsr = pc[3];
+      if (!configured || wanted != current) {
+        SPI.applySettings(wanted);
+        current = wanted;
+        configured = true;
+      }
+      selected = pc[1];
+      spiPinLow(selected);
+      pc += 4;
+      break;
+    }
+    case OP_DESELECT:
+      if (selected != 0xFF)
+        spiPinHigh(selected);
+      selected = 0xFF;
+      pc += 1;
+      break;
+    case OP_WRITE:
+      SPI.transfer(pc + 2, NULL, pc[1]);
+      pc += 2 + pc[1];
+      break;
+    case OP_DELAY:
+      ::delayMicroseconds(pc[1] | (pc[2] << 8));
+      pc += 3;
+      break;
+    }
+  }
+  SPI.endTransaction();
+  return true;
+}
+
+bool SPICommandBuffer::flush()
+{
+  bool played = replay();
+  clear();
+  return played;
+}
+
+void SPICommandBuffer::clear()
+{
+  length = 0;
+  lastWrite = capacity;
+  overflow = false;
+}
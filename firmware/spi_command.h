@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_COMMAND_H_INCLUDED
+#define _SPI_COMMAND_H_INCLUDED
+
+#include "spi.h"
+
+// Records chip selects, settings, writes and delays into a caller
+// supplied arena and plays them back in one pass: the bus is taken once
+// and settings are only reloaded when the selected device changes them.
+// The recording is kept by replay(), so fixed sequences such as display
+// init or sensor wake-up can be recorded once and replayed at will.
+//
+//   static byte arena[32];
+//   SPICommandBuffer init(arena, sizeof(arena));
+//   init.select(chipSelectPin, settings);
+//   init.write(0x02 << 2 | WRITE);
+//   init.write(0x2D);
+//   init.deselect();
+//   ...
+//   init.flush();
+class SPICommandBuffer {
+public:
+  SPICommandBuffer(byte *arena, size_t size);
+
+  // Each recorder returns false, and marks the buffer as overflowed,
+  // if the arena is full. An overflowed buffer is never played back.
+  bool select(uint8_t csPin, SPISettings settings);
+  bool deselect();
+  bool write(byte value);
+  bool write(const void *data, size_t len);
+  bool delayMicroseconds(uint16_t us);
+
+  bool replay() const;
+  bool flush();
+  void clear();
+
+  size_t size() const { return length; }
+  bool overflowed() const { return overflow; }
+
+private:
+  byte *reserve(size_t n);
+
+  byte *arena;
+  size_t capacity;
+  size_t length;
+  size_t lastWrite;
+  bool overflow;
+};
+
+#endif
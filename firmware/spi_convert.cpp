@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_convert.h"
+
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SPI_CONVERT_WORDS 1
+#else
+#define SPI_CONVERT_WORDS 0
+#endif
+
+static inline uint16_t rgb565(byte r, byte g, byte b)
+{
+  return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+}
+
+#if SPI_CONVERT_WORDS
+// Swaps the bytes of both halfwords of a word.
+static inline uint32_t swap16x2(uint32_t x)
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+  uint32_t result;
+  __asm__("rev16 %0, %1" : "=r" (result) : "r" (x));
+  return result;
+#else
+  return ((x & 0x00FF00FFUL) << 8) | ((x >> 8) & 0x00FF00FFUL);
+#endif
+}
+#endif
+
+void spiConvertRGB565(void *dst, const void *src, size_t pixels)
+{
+  const byte *in = (const byte *)src;
+  byte *out = (byte *)dst;
+
+#if SPI_CONVERT_WORDS
+  // Two pixels per store; memcpy keeps unaligned buffers legal and
+  // compiles to a single access where the target allows it.
+  for (; pixels >= 2; pixels -= 2) {
+    uint32_t pair = rgb565(in[0], in[1], in[2]) |
+                    ((uint32_t)rgb565(in[3], in[4], in[5]) << 16);
+    pair = swap16x2(pair);
+    memcpy(out, &pair, 4);
+    in += 6;
+    out += 4;
+  }
+#endif
+  for (; pixels; pixels--) {
+    uint16_t pixel = rgb565(in[0], in[1], in[2]);
+    *out++ = pixel >> 8;
+    *out++ = pixel;
+    in += 3;
+  }
+}
+
+void spiConvertInt16BE(void *dst, const int16_t *src, size_t samples)
+{
+  const byte *in = (const byte *)src;
+  byte *out = (byte *)dst;
+
+#if SPI_CONVERT_WORDS
+  for (; samples >= 2; samples -= 2) {
+    uint32_t pair;
+    memcpy(&pair, in, 4);
+    pair = swap16x2(pair);
+    memcpy(out, &pair, 4);
+    in += 4;
+    out += 4;
+  }
+#endif
+  for (; samples; samples--) {
+    uint16_t sample;
+    memcpy(&sample, in, 2);
+    in += 2;
+    *out++ = sample >> 8;
+    *out++ = sample;
+  }
+}
+
+// Both transfers keep the shifter busy the same way transfer() does:
+// the next byte, converting a new unit when needed, is produced while
+// the current byte shifts, so the conversion costs no bus time as long
+// as it fits in one byte time.
+
+void SPIClass::transferRGB565(const void *rgb888, size_t pixels)
+{
+  const byte *in = (const byte *)rgb888;
+  if (pixels == 0)
+    return;
+
+  uint16_t pixel = rgb565(in[0], in[1], in[2]);
+  in += 3;
+  SPDR = pixel >> 8;
+  while (--pixels) {
+    byte low = pixel;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    SPDR = low;
+    pixel = rgb565(in[0], in[1], in[2]);
+    in += 3;
+    byte high = pixel >> 8;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    SPDR = high;
+  }
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  SPDR = (byte)pixel;
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  (void)SPDR;
+}
+
+void SPIClass::transferInt16BE(const int16_t *samples, size_t count)
+{
+  if (count == 0)
+    return;
+
+  uint16_t sample = *samples++;
+  SPDR = sample >> 8;
+  while (--count) {
+    byte low = sample;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    SPDR = low;
+    sample = *samples++;
+    byte high = sample >> 8;
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    SPDR = high;
+  }
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  SPDR = (byte)sample;
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  (void)SPDR;
+}
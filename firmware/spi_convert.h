@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Buffer format conversions for displays and DACs. The kernels below
+// convert a whole buffer, two units per 32-bit word on little-endian
+// 32-bit targets (REV16 on Cortex-M, shifts and masks elsewhere) and a
+// unit at a time on AVR. To convert on the fly instead, use
+// SPIClass::transferRGB565() and SPIClass::transferInt16BE(), which
+// produce each unit while the previous byte is on the wire.
+
+#ifndef _SPI_CONVERT_H_INCLUDED
+#define _SPI_CONVERT_H_INCLUDED
+
+#include "spi.h"
+
+// RGB888 pixels (r, g, b) to RGB565, high byte first as display
+// controllers expect it. dst holds 2 bytes per pixel and may not
+// overlap src.
+void spiConvertRGB565(void *dst, const void *src, size_t pixels);
+
+// Native int16 samples to big-endian. dst may be the same as src.
+void spiConvertInt16BE(void *dst, const int16_t *src, size_t samples);
+
+#endif
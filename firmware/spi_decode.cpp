@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_decode.h"
+
+static uint16_t readSize(const byte *asset)
+{
+  return pgm_read_byte(asset) | ((uint16_t)pgm_read_byte(asset + 1) << 8);
+}
+
+SPIRLEDecoder::SPIRLEDecoder(const byte *asset)
+  : source(asset + 2), left(readSize(asset)), run(0), repeat(false), value(0)
+{
+}
+
+byte SPIRLEDecoder::next()
+{
+  if (left == 0)
+    return 0x00;
+  if (run == 0) {
+    byte control = pgm_read_byte(source++);
+    repeat = control & 0x80;
+    if (repeat) {
+      run = (control & 0x7F) + 2;
+      value = pgm_read_byte(source++);
+    } else {
+      run = control + 1;
+    }
+  }
+  run--;
+  left--;
+  return repeat ? value : pgm_read_byte(source++);
+}
+
+SPILZDecoder::SPILZDecoder(const byte *asset)
+  : source(asset + 2), left(readSize(asset)), distance(1), match(0),
+    flags(0), flagBits(0), position(0)
+{
+  memset(window, 0, sizeof(window));
+}
+
+byte SPILZDecoder::next()
+{
+  if (left == 0)
+    return 0x00;
+
+  byte out;
+  if (match) {
+    match--;
+    out = window[(uint8_t)(position - distance)];
+  } else {
+    if (flagBits == 0) {
+      flags = pgm_read_byte(source++);
+      flagBits = 8;
+    }
+    flagBits--;
+    bool literal = flags & 0x01;
+    flags >>= 1;
+    if (literal) {
+      out = pgm_read_byte(source++);
+    } else {
+      // A distance of 256 lands on the slot about to be overwritten,
+      // which still holds the byte from 256 back.
+      distance = pgm_read_byte(source++) + 1;
+      match = pgm_read_byte(source++) + 2;
+      out = window[(uint8_t)(position - distance)];
+    }
+  }
+  window[position++] = out;
+  left--;
+  return out;
+}
+
+// Same pipelining as SPIClass::transfer(): the next byte is decoded
+// while the current one is on the wire. A template rather than a base
+// class so next() stays a direct, inlinable call.
+template <class Decoder>
+static uint16_t sendDecoded(Decoder &decoder, uint16_t count)
+{
+  if (count == 0)
+    return 0;
+
+  SPDR = decoder.next();
+  for (uint16_t i = 1; i < count; i++) {
+    byte out = decoder.next();
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    (void)SPDR;
+    SPDR = out;
+  }
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  (void)SPDR;
+  return count;
+}
+
+uint16_t SPIRLEDecoder::send(uint16_t count)
+{
+  return sendDecoded(*this, count < left ? count : left);
+}
+
+uint16_t SPILZDecoder::send(uint16_t count)
+{
+  return sendDecoded(*this, count < left ? count : left);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Streaming decoders for compressed assets in PROGMEM. Bytes are decoded
+// one at a time and written to SPDR as they come out, the next one
+// being decoded while the current one shifts, so an image or init table
+// never has to be unpacked into RAM.
+//
+// Both formats start with the decoded size, 16 bits little-endian.
+//
+// RLE: a control byte c, then
+//   c < 0x80    c + 1 literal bytes
+//   c >= 0x80   one byte, repeated (c & 0x7F) + 2 times
+//
+// LZ: a flag byte, then eight items described by its bits, LSB first:
+//   1  one literal byte
+//   0  two bytes: distance - 1 (1..256 back), length - 3 (3..258)
+// Matches copy from the last 256 decoded bytes and may overlap the
+// bytes they produce. The data may stop partway through a flag byte.
+//
+//   SPILZDecoder splash(splashImage);
+//   digitalWrite(displayCs, LOW);
+//   splash.send(splash.remaining());
+//   digitalWrite(displayCs, HIGH);
+
+#ifndef _SPI_DECODE_H_INCLUDED
+#define _SPI_DECODE_H_INCLUDED
+
+#include "spi.h"
+
+class SPIRLEDecoder {
+public:
+  explicit SPIRLEDecoder(const byte *asset);
+
+  uint16_t remaining() const { return left; }
+  byte next();
+  // Sends up to count decoded bytes; returns how many were sent.
+  uint16_t send(uint16_t count);
+
+private:
+  const byte *source;
+  uint16_t left;
+  uint8_t run;
+  bool repeat;
+  byte value;
+};
+
+// Keeps a 256-byte history window: that, and no buffer for the asset,
+// is all the RAM a decode takes.
+class SPILZDecoder {
+public:
+  explicit SPILZDecoder(const byte *asset);
+
+  uint16_t remaining() const { return left; }
+  byte next();
+  uint16_t send(uint16_t count);
+
+private:
+  const byte *source;
+  uint16_t left;
+  uint16_t distance;
+  uint16_t match;
+  uint8_t flags;
+  uint8_t flagBits;
+  uint8_t position;
+  byte window[256];
+};
+
+#endif
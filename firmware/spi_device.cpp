@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_device.h"
+
+SPIDevice *SPIDevice::devices[SPI_MAX_DEVICES];
+uint8_t SPIDevice::registered = 0;
+
+SPIDevice::SPIDevice(uint8_t cs, SPISettings s, const char *name)
+  : settings(s), csPin(cs), index(0xFF), label(name), current(0), selectedAt(0),
+    errorRun(0), faulted(false)
+{
+  resetStats();
+}
+
+bool SPIDevice::begin()
+{
+  spiPinHigh(csPin);
+  spiPinOutput(csPin);
+  if (index != 0xFF)
+    return true;
+  uint8_t slot = 0;
+  while (slot < registered && devices[slot])
+    slot++;
+  if (slot == SPI_MAX_DEVICES)
+    return false;
+  if (slot == registered)
+    registered++;
+  index = slot;
+  devices[slot] = this;
+  return true;
+}
+
+void SPIDevice::end()
+{
+  if (index == 0xFF)
+    return;
+  devices[index] = NULL;
+  index = 0xFF;
+  while (registered && !devices[registered - 1])
+    registered--;
+}
+
+void SPIDevice::select()
+{
+  // An error reported after the last deselect() still belongs to that
+  // transaction, so the run is only broken here.
+  if (!faulted)
+    errorRun = 0;
+  faulted = false;
+  SPI.beginTransaction(settings);
+  spiPinLow(csPin);
+#ifdef SPI_PROFILING
+  SPIProfiler::selected(index);
+#endif
+  current = 0;
+  selectedAt = micros();
+}
+
+void SPIDevice::deselect()
+{
+  uint32_t hold = micros() - selectedAt;
+  spiPinHigh(csPin);
+#ifdef SPI_PROFILING
+  SPIProfiler::deselected(index, current);
+#endif
+  SPI.endTransaction();
+
+  counters.transactions++;
+  if (hold > counters.maxHold)
+    counters.maxHold = hold > 0xFFFF ? 0xFFFF : hold;
+}
+
+byte SPIDevice::transfer(byte data)
+{
+  current++;
+  counters.bytesOut++;
+  counters.bytesIn++;
+  return SPI.transfer(data);
+}
+
+void SPIDevice::transfer(const void *txBuf, void *rxBuf, size_t count, byte fill)
+{
+  SPI.transfer(txBuf, rxBuf, count, fill);
+  current += count;
+  if (txBuf)
+    counters.bytesOut += count;
+  if (rxBuf)
+    counters.bytesIn += count;
+}
+
+uint8_t SPIDevice::tryTransfer(const void *txBuf, void *rxBuf, size_t count,
+                               uint16_t timeout)
+{
+  uint8_t status = SPI.tryTransfer(txBuf, rxBuf, count, timeout);
+  if (status != SPI_OK) {
+    failed();
+    return status;
+  }
+  current += count;
+  if (txBuf)
+    counters.bytesOut += count;
+  if (rxBuf)
+    counters.bytesIn += count;
+  return status;
+}
+
+void SPIDevice::failed()
+{
+  counters.errors++;
+  if (faulted)
+    return;
+  faulted = true;
+  if (++errorRun < SPI_DEVICE_FALLBACK_ERRORS)
+    return;
+  errorRun = 0;
+  if (settings.slowDown())
+    counters.fallbacks++;
+}
+
+void SPIDevice::resetStats()
+{
+  memset(&counters, 0, sizeof(counters));
+}
+
+SPIDevice *SPIDevice::device(uint8_t id)
+{
+  return id < registered ? devices[id] : NULL;
+}
+
+static byte *put(byte *out, uint32_t value, uint8_t size)
+{
+  for (uint8_t i = 0; i < size; i++)
+    *out++ = value >> (8 * i);
+  return out;
+}
+
+size_t SPIDevice::snapshot(byte *buf, size_t len)
+{
+  uint8_t live = 0;
+  for (uint8_t i = 0; i < registered; i++) {
+    if (devices[i])
+      live++;
+  }
+  size_t needed = 2 + (size_t)live * SPI_DEVICE_RECORD_SIZE;
+  if (len < needed)
+    return 0;
+
+  byte *out = buf;
+  *out++ = SPI_DEVICE_FORMAT;
+  *out++ = live;
+  for (uint8_t i = 0; i < registered; i++) {
+    if (!devices[i])
+      continue;
+    const SPIDeviceStats &s = devices[i]->counters;
+    *out++ = devices[i]->csPin;
+    out = put(out, s.bytesOut, 4);
+    out = put(out, s.bytesIn, 4);
+    out = put(out, s.transactions, 4);
+    out = put(out, s.maxHold, 2);
+    out = put(out, s.retries, 2);
+    out = put(out, s.errors, 2);
+    out = put(out, s.fallbacks, 2);
+  }
+  return out - buf;
+}
+
+void SPIDevice::resetAll()
+{
+  for (uint8_t i = 0; i < registered; i++) {
+    if (devices[i])
+      devices[i]->resetStats();
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_DEVICE_H_INCLUDED
+#define _SPI_DEVICE_H_INCLUDED
+
+#include "spi.h"
+
+#ifdef SPI_PROFILING
+#include "spi_profiler.h"
+#endif
+
+#ifndef SPI_MAX_DEVICES
+#define SPI_MAX_DEVICES 8
+#endif
+
+// Transactions in a row with an error before the clock drops a step.
+#ifndef SPI_DEVICE_FALLBACK_ERRORS
+#define SPI_DEVICE_FALLBACK_ERRORS 3
+#endif
+
+#define SPI_DEVICE_FORMAT 2
+// Per device in a snapshot: cs pin, bytes out, bytes in, transactions,
+// max hold, retries, errors, fallbacks.
+#define SPI_DEVICE_RECORD_SIZE 21
+
+struct SPIDeviceStats {
+  uint32_t bytesOut;      // bytes sent from caller data
+  uint32_t bytesIn;       // bytes handed back to the caller
+  uint32_t transactions;
+  uint16_t maxHold;       // longest chip select assertion, us
+  uint16_t retries;
+  uint16_t errors;        // failed() calls, including failed tryTransfer()
+  uint16_t fallbacks;     // clock steps dropped after repeated errors
+};
+
+// A peripheral on the bus: its chip select, settings and a name for
+// reports. Transfers made through select()/transfer()/deselect() are
+// counted; the counters are plain increments, and the clock is read
+// only at select and deselect.
+//
+//   SPIDevice pressure(7, SPISettings(SPI_CLOCK_DIV16, MSBFIRST, SPI_MODE0), "scp1000");
+//   pressure.begin();
+//   pressure.select();
+//   pressure.transfer(cmd, reply, sizeof(reply));
+//   pressure.deselect();
+//
+// A registered device is listed until end() or its destructor, so a
+// device on the stack drops out when it goes out of scope.
+class SPIDevice {
+public:
+  SPIDevice(uint8_t csPin, SPISettings settings, const char *name = NULL);
+  ~SPIDevice() { end(); }
+
+  // Registers the device and drives its chip select high. Returns false
+  // if SPI_MAX_DEVICES are already registered; the device still works
+  // but is left out of snapshots.
+  bool begin();
+  // Unregisters the device. Its id is free for the next begin().
+  void end();
+
+  void select();
+  void deselect();
+  byte transfer(byte data);
+  void transfer(const void *txBuf, void *rxBuf, size_t count, byte fill = 0x00);
+  // As SPIClass::tryTransfer(); an error is reported through failed().
+  uint8_t tryTransfer(const void *txBuf, void *rxBuf, size_t count,
+                      uint16_t timeout = SPI_DEFAULT_TIMEOUT);
+  // For drivers to report a command they had to repeat.
+  void retried() { counters.retries++; }
+  // For drivers to report a bad answer: a CRC mismatch, a wrong ID, a
+  // status that never came ready. Once SPI_DEVICE_FALLBACK_ERRORS
+  // transactions in a row have had one, the clock drops one step from
+  // the next select() on.
+  void failed();
+
+  // Finds the fastest divider at which probe passes, as
+  // SPIClass::tuneClock(), and keeps it for this device.
+  bool tuneClock(SPIProbeFunc probe, void *context, uint8_t trials = 8) {
+    return SPIClass::tuneClock(settings, probe, context, trials);
+  }
+  uint8_t clockDivider() const { return settings.clockDivider(); }
+
+  const SPIDeviceStats &stats() const { return counters; }
+  const char *name() const { return label; }
+  uint8_t pin() const { return csPin; }
+  // Slot in the registry, or 0xFF if not registered.
+  uint8_t id() const { return index; }
+  void resetStats();
+
+  // Ids run below count(); device() returns NULL for a slot whose
+  // device has ended.
+  static uint8_t count() { return registered; }
+  static SPIDevice *device(uint8_t id);
+
+  // Little-endian snapshot of all registered devices: format byte,
+  // device count, then SPI_DEVICE_RECORD_SIZE bytes per device in id
+  // order. Returns the bytes written, or 0 if buf is too small.
+  static size_t snapshot(byte *buf, size_t len);
+  static void resetAll();
+
+private:
+  SPISettings settings;
+  uint8_t csPin;
+  uint8_t index;
+  const char *label;
+  uint16_t current;       // bytes in the open transaction
+  uint32_t selectedAt;
+  uint8_t errorRun;       // transactions in a row with an error
+  bool faulted;           // failed() since the last select()
+  SPIDeviceStats counters;
+
+  static SPIDevice *devices[SPI_MAX_DEVICES];
+  static uint8_t registered;  // slots in use, ended ones included
+};
+
+#endif
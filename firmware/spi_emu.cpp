@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifdef SPI_EMULATION
+
+#include <algorithm>
+#include <vector>
+#include "spi.h"
+
+enum { SIG_SCK, SIG_MOSI, SIG_MISO, SIG_CS };
+
+#define SPI_EMU_SIGNALS (SIG_CS + SPI_EMU_DEVICES)
+
+struct Event {
+  uint64_t at;
+  uint8_t signal;
+  uint8_t value;
+};
+
+struct ByteRecord {
+  uint64_t start;
+  uint64_t end;
+  int8_t device;
+  int32_t transaction;
+};
+
+struct Transaction {
+  int8_t device;
+  bool clocked;
+  bool closed;
+  uint64_t low;
+  uint64_t high;
+  uint64_t firstEdge;
+  uint64_t lastEdge;
+};
+
+volatile uint8_t SREG;
+
+static const SPIEmuCosts defaultCosts = { 1, 4, 56 };
+SPIEmuCosts SPIEmulator::costs = defaultCosts;
+
+uint8_t SPIEmulator::pinLevels[SPI_EMU_PINS];
+uint8_t SPIEmulator::pinModes[SPI_EMU_PINS];
+volatile uint8_t SPIEmulator::portOut[SPI_EMU_PORTS];
+volatile uint8_t SPIEmulator::portIn[SPI_EMU_PORTS];
+volatile uint8_t SPIEmulator::portDir[SPI_EMU_PORTS];
+uint64_t SPIEmulator::now;
+
+static uint8_t spcr;
+static uint8_t spsr;
+static uint8_t rxData;
+static uint8_t pending;
+static bool shifting;
+static bool clearArmed;
+static bool inInterrupt;
+static uint64_t shiftEnd;
+static void (*interruptHandler)(void);
+
+static uint8_t deviceCount;
+static uint8_t devicePins[SPI_EMU_DEVICES];
+static SPIEmuDevice *devices[SPI_EMU_DEVICES];
+static int8_t selected = -1;
+
+static bool tracing;
+static uint64_t traceStart;
+static uint8_t initialLevel[SPI_EMU_SIGNALS];
+static uint8_t lastLevel[SPI_EMU_SIGNALS];
+static int32_t openTransaction[SPI_EMU_DEVICES];
+static std::vector<Event> events;
+static std::vector<ByteRecord> byteRecords;
+static std::vector<Transaction> transactionRecords;
+
+static const uint8_t dividers[4] = { 4, 16, 64, 128 };
+
+SPIEmuRegister::operator uint8_t() const
+{
+  return SPIEmulator::load(id);
+}
+
+SPIEmuRegister &SPIEmuRegister::operator=(int value)
+{
+  SPIEmulator::store(id, (uint8_t)value);
+  return *this;
+}
+
+void SPIEmulator::reset()
+{
+  now = 0;
+  costs = defaultCosts;
+  spcr = spsr = rxData = pending = 0;
+  shifting = clearArmed = inInterrupt = false;
+  SREG = _BV(SREG_I);  // init() leaves interrupts on
+  memset(pinLevels, 0, sizeof(pinLevels));
+  memset(pinModes, 0, sizeof(pinModes));
+  memset((void *)portOut, 0, sizeof(portOut));
+  memset((void *)portIn, 0, sizeof(portIn));
+  memset((void *)portDir, 0, sizeof(portDir));
+  detachAll();
+  stopTrace();
+}
+
+// CS lines idle high, as if pulled up, so the first LOW selects.
+void SPIEmulator::attach(uint8_t csPin, SPIEmuDevice *device)
+{
+  if (deviceCount == SPI_EMU_DEVICES)
+    return;
+  devicePins[deviceCount] = csPin;
+  devices[deviceCount] = device;
+  openTransaction[deviceCount] = -1;
+  deviceCount++;
+  pinLevels[csPin] = HIGH;
+}
+
+void SPIEmulator::detachAll()
+{
+  deviceCount = 0;
+  selected = -1;
+}
+
+void SPIEmulator::setInterruptHandler(void (*handler)(void))
+{
+  interruptHandler = handler;
+}
+
+void SPIEmulator::injectModeFault()
+{
+  spcr &= ~_BV(MSTR);
+  spsr |= _BV(SPIF);
+  shifting = false;
+}
+
+void SPIEmulator::advance(uint32_t count)
+{
+  uint64_t target = now + count;
+  while (shifting && shiftEnd <= target) {
+    if (now < shiftEnd)
+      now = shiftEnd;
+    settle();
+  }
+  if (now < target)
+    now = target;
+  settle();
+}
+
+// Completes a shift whose time has come and, as the hardware does on
+// vector entry, clears SPIF and the global interrupt flag before
+// calling an attached handler. A completion that arrived with
+// interrupts off is taken once they are back on.
+void SPIEmulator::settle()
+{
+  if (shifting && now >= shiftEnd) {
+    shifting = false;
+    rxData = pending;
+    spsr |= _BV(SPIF);
+  }
+  if ((spsr & _BV(SPIF)) && (spcr & _BV(SPIE)) && (SREG & _BV(SREG_I)) &&
+      interruptHandler && !inInterrupt) {
+    uint8_t sreg = SREG;
+    inInterrupt = true;
+    SREG &= ~_BV(SREG_I);
+    spsr &= ~_BV(SPIF);
+    clearArmed = false;
+    interruptHandler();
+    SREG = sreg;
+    inInterrupt = false;
+  }
+}
+
+// Every register access costs time. Reading SPSR with SPIF or WCOL set
+// arms the flag clear that the next SPDR access performs.
+SPIEmuRegister SPIEmulator::access(uint8_t id)
+{
+  if (id == REG_SPSR) {
+    now += costs.statusPoll;
+    settle();
+    if (spsr & (_BV(SPIF) | _BV(WCOL)))
+      clearArmed = true;
+  } else {
+    now += costs.registerAccess;
+    settle();
+    if (id == REG_SPDR && clearArmed) {
+      spsr &= ~(_BV(SPIF) | _BV(WCOL));
+      clearArmed = false;
+    }
+  }
+  return SPIEmuRegister(id);
+}
+
+uint8_t SPIEmulator::load(uint8_t id)
+{
+  switch (id) {
+  case REG_SPCR:
+    return spcr;
+  case REG_SPSR:
+    return spsr;
+  default:
+    return rxData;
+  }
+}
+
+void SPIEmulator::store(uint8_t id, uint8_t value)
+{
+  switch (id) {
+  case REG_SPCR:
+    if (!(value & _BV(SPE)))
+      shifting = false;
+    spcr = value;
+    break;
+  case REG_SPSR:
+    spsr = (spsr & ~_BV(SPI2X)) | (value & _BV(SPI2X));
+    break;
+  default:
+    if (!(spcr & _BV(SPE)) || !(spcr & _BV(MSTR)))
+      break;
+    if (shifting)
+      spsr |= _BV(WCOL);
+    else
+      startShift(value);
+    break;
+  }
+}
+
+void SPIEmulator::writePin(uint8_t pin, uint8_t level)
+{
+  now += costs.digitalWrite;
+  settle();
+
+  level = level ? HIGH : LOW;
+  uint8_t old = pinLevels[pin];
+  pinLevels[pin] = level;
+  if (old == level)
+    return;
+
+  for (uint8_t d = 0; d < deviceCount; d++) {
+    if (devicePins[d] != pin)
+      continue;
+    if (level == LOW) {
+      selected = d;
+      devices[d]->select();
+      if (tracing) {
+        Transaction t = { (int8_t)d, false, false, now, 0, 0, 0 };
+        openTransaction[d] = transactionRecords.size();
+        transactionRecords.push_back(t);
+      }
+    } else {
+      if (selected == d)
+        selected = -1;
+      devices[d]->deselect();
+      if (tracing && openTransaction[d] >= 0) {
+        transactionRecords[openTransaction[d]].high = now;
+        transactionRecords[openTransaction[d]].closed = true;
+        openTransaction[d] = -1;
+      }
+    }
+    record(now, SIG_CS + d, level);
+  }
+}
+
+void SPIEmulator::startShift(byte value)
+{
+  uint8_t divider = dividers[spcr & SPI_CLOCK_MASK] >> (spsr & SPI_2XCLOCK_MASK);
+  bool lsbFirst = spcr & _BV(DORD);
+  byte wireOut = lsbFirst ? SPIClass::reverseBits(value) : value;
+  byte wireIn = selected >= 0 ? devices[selected]->exchange(wireOut) : 0xFF;
+
+  pending = lsbFirst ? SPIClass::reverseBits(wireIn) : wireIn;
+  shifting = true;
+  shiftEnd = now + 8 * divider;
+  if (!tracing)
+    return;
+
+  uint8_t idle = (spcr & _BV(CPOL)) ? 1 : 0;
+  bool cpha = spcr & _BV(CPHA);
+  uint8_t half = divider / 2;
+  for (uint8_t i = 0; i < 8; i++) {
+    uint64_t t = now + i * divider;
+    uint8_t out = (wireOut >> (7 - i)) & 1;
+    uint8_t in = (wireIn >> (7 - i)) & 1;
+    if (cpha) {
+      record(t, SIG_SCK, !idle);
+      record(t, SIG_MOSI, out);
+      record(t, SIG_MISO, in);
+      record(t + half, SIG_SCK, idle);
+    } else {
+      record(t, SIG_MOSI, out);
+      record(t, SIG_MISO, in);
+      record(t + half, SIG_SCK, !idle);
+      record(t + divider, SIG_SCK, idle);
+    }
+  }
+
+  int32_t transaction = selected >= 0 ? openTransaction[selected] : -1;
+  ByteRecord b = { now, shiftEnd, selected, transaction };
+  byteRecords.push_back(b);
+  if (transaction >= 0) {
+    Transaction &t = transactionRecords[transaction];
+    if (!t.clocked)
+      t.firstEdge = cpha ? now : now + half;
+    t.lastEdge = cpha ? now + 7 * divider + half : shiftEnd;
+    t.clocked = true;
+  }
+}
+
+void SPIEmulator::record(uint64_t at, uint8_t signal, uint8_t value)
+{
+  if (!tracing || lastLevel[signal] == value)
+    return;
+  lastLevel[signal] = value;
+  Event e = { at, signal, value };
+  events.push_back(e);
+}
+
+void SPIEmulator::startTrace()
+{
+  events.clear();
+  byteRecords.clear();
+  transactionRecords.clear();
+  for (uint8_t d = 0; d < SPI_EMU_DEVICES; d++)
+    openTransaction[d] = -1;
+
+  initialLevel[SIG_SCK] = (spcr & _BV(CPOL)) ? 1 : 0;
+  initialLevel[SIG_MOSI] = 0;
+  initialLevel[SIG_MISO] = 1;
+  for (uint8_t d = 0; d < deviceCount; d++)
+    initialLevel[SIG_CS + d] = pinLevels[devicePins[d]];
+  memcpy(lastLevel, initialLevel, sizeof(lastLevel));
+  traceStart = now;
+  tracing = true;
+}
+
+void SPIEmulator::stopTrace()
+{
+  tracing = false;
+}
+
+static bool earlier(const Event &a, const Event &b)
+{
+  return a.at < b.at;
+}
+
+bool SPIEmulator::writeVcd(const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return false;
+
+  const uint64_t psPerCycle = 1000000000000ULL / F_CPU;
+  fprintf(f, "$timescale 1ps $end\n$scope module spi $end\n");
+  fprintf(f, "$var wire 1 %c sck $end\n", '!' + SIG_SCK);
+  fprintf(f, "$var wire 1 %c mosi $end\n", '!' + SIG_MOSI);
+  fprintf(f, "$var wire 1 %c miso $end\n", '!' + SIG_MISO);
+  for (uint8_t d = 0; d < deviceCount; d++)
+    fprintf(f, "$var wire 1 %c cs%u $end\n", '!' + SIG_CS + d, devicePins[d]);
+  fprintf(f, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+  for (uint8_t s = 0; s < SIG_CS + deviceCount; s++)
+    fprintf(f, "%u%c\n", initialLevel[s], '!' + s);
+  fprintf(f, "$end\n");
+
+  std::vector<Event> sorted(events);
+  std::stable_sort(sorted.begin(), sorted.end(), earlier);
+  uint64_t last = 0;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    uint64_t at = (sorted[i].at - traceStart) * psPerCycle;
+    if (at != last) {
+      fprintf(f, "#%llu\n", (unsigned long long)at);
+      last = at;
+    }
+    fprintf(f, "%u%c\n", sorted[i].value, '!' + sorted[i].signal);
+  }
+  return fclose(f) == 0;
+}
+
+// Largest idle time between two consecutive bytes of one transaction.
+uint32_t SPIEmulator::maxByteGap(int8_t device)
+{
+  uint32_t worst = 0;
+  for (size_t i = 1; i < byteRecords.size(); i++) {
+    const ByteRecord &prev = byteRecords[i - 1];
+    const ByteRecord &cur = byteRecords[i];
+    if (cur.transaction < 0 || cur.transaction != prev.transaction)
+      continue;
+    if (device >= 0 && cur.device != device)
+      continue;
+    uint32_t gap = cur.start > prev.end ? cur.start - prev.end : 0;
+    if (gap > worst)
+      worst = gap;
+  }
+  return worst;
+}
+
+// CS falling edge to first SCK edge. SPI_EMU_NONE if nothing was clocked.
+uint32_t SPIEmulator::minSetup(int8_t device)
+{
+  uint32_t best = SPI_EMU_NONE;
+  for (size_t i = 0; i < transactionRecords.size(); i++) {
+    const Transaction &t = transactionRecords[i];
+    if (!t.clocked || (device >= 0 && t.device != device))
+      continue;
+    uint32_t setup = t.firstEdge - t.low;
+    if (setup < best)
+      best = setup;
+  }
+  return best;
+}
+
+// Last SCK edge to CS rising edge. SPI_EMU_NONE if nothing was clocked.
+uint32_t SPIEmulator::minHold(int8_t device)
+{
+  uint32_t best = SPI_EMU_NONE;
+  for (size_t i = 0; i < transactionRecords.size(); i++) {
+    const Transaction &t = transactionRecords[i];
+    if (!t.clocked || !t.closed || (device >= 0 && t.device != device))
+      continue;
+    uint32_t hold = t.high > t.lastEdge ? t.high - t.lastEdge : 0;
+    if (hold < best)
+      best = hold;
+  }
+  return best;
+}
+
+uint32_t SPIEmulator::transactions(int8_t device)
+{
+  uint32_t count = 0;
+  for (size_t i = 0; i < transactionRecords.size(); i++) {
+    if (device < 0 || transactionRecords[i].device == device)
+      count++;
+  }
+  return count;
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Host emulation of the AVR SPI peripheral, used in place of Arduino.h
+// when the library is compiled with -DSPI_EMULATION. SPCR, SPSR and SPDR
+// are backed by a model that keeps a CPU cycle count, shifts bytes at
+// the configured divider, talks to attached SPIEmuDevice models and can
+// record the resulting SCK/MOSI/MISO/CS waveform.
+//
+// Time only moves when the code touches the emulated hardware: each
+// register access, digitalWrite() and delay costs the cycles configured
+// in SPIEmulator::costs, so the trace reflects the library's own access
+// pattern rather than host speed.
+//
+// The host tests in test/ are built this way: make -C test check.
+
+#ifndef _SPI_EMU_H_INCLUDED
+#define _SPI_EMU_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef uint8_t byte;
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+// SPCR
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+// SPSR
+#define SPIF 7
+#define WCOL 6
+#define SPI2X 0
+// SREG
+#define SREG_I 7
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define SS 10
+#define MOSI 11
+#define MISO 12
+#define SCK 13
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+#define SPI_EMU_PINS 64
+#define SPI_EMU_PORTS (SPI_EMU_PINS / 8)
+#define SPI_EMU_DEVICES 8
+#define SPI_EMU_NONE 0xFFFFFFFFUL
+
+// A virtual peripheral on the emulated bus, selected by its CS pin.
+// exchange() sees bytes in wire order, first bit received as the MSB,
+// whatever DORD is set to.
+class SPIEmuDevice {
+public:
+  virtual ~SPIEmuDevice() {}
+  virtual void select() {}
+  virtual byte exchange(byte mosi) = 0;
+  virtual void deselect() {}
+};
+
+class SPIEmuRegister {
+public:
+  explicit SPIEmuRegister(uint8_t id) : id(id) {}
+  operator uint8_t() const;
+  SPIEmuRegister &operator=(int value);
+  SPIEmuRegister &operator|=(int value) { return *this = *this | value; }
+  SPIEmuRegister &operator&=(int value) { return *this = *this & value; }
+
+private:
+  uint8_t id;
+};
+
+struct SPIEmuCosts {
+  uint8_t registerAccess;  // SPCR/SPDR load or store
+  uint8_t statusPoll;      // one iteration of a SPIF polling loop
+  uint8_t digitalWrite;
+};
+
+class SPIEmulator {
+public:
+  enum { REG_SPCR, REG_SPSR, REG_SPDR };
+
+  static SPIEmuCosts costs;
+
+  static void reset();
+  static void attach(uint8_t csPin, SPIEmuDevice *device);
+  static void detachAll();
+  static void setInterruptHandler(void (*handler)(void));
+
+  static uint64_t cycles() { return now; }
+  static void advance(uint32_t cycles);
+  // Simulates SS being pulled low while configured as an input.
+  static void injectModeFault();
+
+  // Waveform capture. Nothing is recorded unless tracing is on.
+  static void startTrace();
+  static void stopTrace();
+  static bool writeVcd(const char *path);
+
+  // Timing checks over the recorded trace, in CPU cycles. A device
+  // index is the order of attach() calls; -1 means any device.
+  static uint32_t maxByteGap(int8_t device = -1);
+  static uint32_t minSetup(int8_t device = -1);
+  static uint32_t minHold(int8_t device = -1);
+  static uint32_t transactions(int8_t device = -1);
+
+  // Pin and port state behind the Arduino shims.
+  static uint8_t pinLevels[SPI_EMU_PINS];
+  static uint8_t pinModes[SPI_EMU_PINS];
+  static volatile uint8_t portOut[SPI_EMU_PORTS];
+  static volatile uint8_t portIn[SPI_EMU_PORTS];
+  static volatile uint8_t portDir[SPI_EMU_PORTS];
+
+  static SPIEmuRegister access(uint8_t id);
+  static uint8_t load(uint8_t id);
+  static void store(uint8_t id, uint8_t value);
+  static void writePin(uint8_t pin, uint8_t level);
+
+private:
+  static void settle();
+  static void startShift(byte value);
+  static void record(uint64_t at, uint8_t signal, uint8_t value);
+
+  static uint64_t now;
+};
+
+#define SPCR (SPIEmulator::access(SPIEmulator::REG_SPCR))
+#define SPSR (SPIEmulator::access(SPIEmulator::REG_SPSR))
+#define SPDR (SPIEmulator::access(SPIEmulator::REG_SPDR))
+
+// Only the global interrupt flag is modelled. The SPI handler runs when
+// SPIF, SPIE and SREG_I are all set at a register access or advance().
+extern volatile uint8_t SREG;
+
+inline void noInterrupts() { SREG &= ~_BV(SREG_I); }
+inline void interrupts() { SREG |= _BV(SREG_I); }
+inline void pinMode(uint8_t pin, uint8_t mode) { SPIEmulator::pinModes[pin] = mode; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { SPIEmulator::writePin(pin, level); }
+inline int digitalRead(uint8_t pin) { return SPIEmulator::pinLevels[pin]; }
+inline unsigned long micros() { return SPIEmulator::cycles() / (F_CPU / 1000000UL); }
+inline unsigned long millis() { return SPIEmulator::cycles() / (F_CPU / 1000UL); }
+inline void delayMicroseconds(unsigned int us) { SPIEmulator::advance(us * (F_CPU / 1000000UL)); }
+inline void delay(unsigned long ms) { while (ms--) delayMicroseconds(1000); }
+
+#define digitalPinToPort(pin) ((pin) / 8)
+#define digitalPinToBitMask(pin) _BV((pin) % 8)
+#define portOutputRegister(port) (&SPIEmulator::portOut[port])
+#define portInputRegister(port) (&SPIEmulator::portIn[port])
+#define portModeRegister(port) (&SPIEmulator::portDir[port])
+
+#endif
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifdef SPI_EMULATION
+
+#include "spi_emu_devices.h"
+
+// Each exchange() returns what the part drives on MISO while the byte is
+// shifted, so it may only depend on bytes received before it.
+
+SPIEmuRegisterSensor::SPIEmuRegisterSensor()
+  : dataReadyPin(-1), command(true), writing(false), reg(0), index(0), incoming(0)
+{
+  for (uint8_t i = 0; i < 64; i++) {
+    values[i] = 0;
+    widths[i] = 1;
+  }
+}
+
+void SPIEmuRegisterSensor::setRegister(uint8_t r, uint32_t value, uint8_t width)
+{
+  values[r & 0x3F] = value;
+  widths[r & 0x3F] = (width >= 1 && width <= 4) ? width : 1;
+}
+
+void SPIEmuRegisterSensor::setDataReadyPin(uint8_t pin)
+{
+  dataReadyPin = pin;
+  setDataReady(false);
+}
+
+void SPIEmuRegisterSensor::setDataReady(bool ready)
+{
+  if (dataReadyPin >= 0)
+    SPIEmulator::pinLevels[dataReadyPin] = ready ? HIGH : LOW;
+}
+
+void SPIEmuRegisterSensor::select()
+{
+  command = true;
+}
+
+byte SPIEmuRegisterSensor::exchange(byte mosi)
+{
+  if (command) {
+    command = false;
+    reg = (mosi >> 2) & 0x3F;
+    writing = mosi & 0x02;
+    index = 0;
+    incoming = 0;
+    return 0x00;
+  }
+
+  uint8_t width = widths[reg];
+  if (writing) {
+    incoming = (incoming << 8) | mosi;
+    if (++index == width) {
+      values[reg] = incoming;
+      written(reg, incoming);
+      index = 0;
+      incoming = 0;
+    }
+    return 0x00;
+  }
+
+  byte out = 0x00;
+  if (index < width)
+    out = values[reg] >> (8 * (width - 1 - index));
+  if (++index == width)
+    read(reg);
+  return out;
+}
+
+#define SCP1000_OPERATION 0x03
+#define SCP1000_DATARD8 0x1F
+#define SCP1000_DATARD16 0x20
+#define SCP1000_TEMPOUT 0x21
+
+SPIEmuSCP1000::SPIEmuSCP1000(uint8_t pin)
+  : temperature(0), pressure(0)
+{
+  setRegister(SCP1000_DATARD8, 0, 1);
+  setRegister(SCP1000_DATARD16, 0, 2);
+  setRegister(SCP1000_TEMPOUT, 0, 2);
+  setDataReadyPin(pin);
+}
+
+// Raw values as the part reports them: temperature in 1/20 degC,
+// pressure as a 19-bit count of 1/4 Pa.
+void SPIEmuSCP1000::setSample(uint16_t rawTemperature, uint32_t rawPressure)
+{
+  temperature = rawTemperature;
+  pressure = rawPressure & 0x7FFFF;
+}
+
+// Fetching the low pressure word completes a sample.
+void SPIEmuSCP1000::read(uint8_t r)
+{
+  if (r == SCP1000_DATARD16)
+    setDataReady(false);
+}
+
+void SPIEmuSCP1000::written(uint8_t r, uint32_t value)
+{
+  if (r != SCP1000_OPERATION || value == 0x00)
+    return;
+  setRegister(SCP1000_TEMPOUT, temperature, 2);
+  setRegister(SCP1000_DATARD8, pressure >> 16, 1);
+  setRegister(SCP1000_DATARD16, pressure & 0xFFFF, 2);
+  setDataReady(true);
+}
+
+SPIEmuDigitalPot::SPIEmuDigitalPot()
+  : shift(0), bits(0), latched(0)
+{
+  for (uint8_t i = 0; i < 6; i++)
+    wipers[i] = 0x80;
+}
+
+void SPIEmuDigitalPot::select()
+{
+  shift = 0;
+  bits = 0;
+}
+
+byte SPIEmuDigitalPot::exchange(byte mosi)
+{
+  shift = (shift << 8) | mosi;
+  if (bits < 16)
+    bits += 8;
+  return 0x00;
+}
+
+void SPIEmuDigitalPot::deselect()
+{
+  if (bits < 11)
+    return;
+  uint8_t address = (shift >> 8) & 0x07;
+  if (address < 6) {
+    wipers[address] = shift & 0xFF;
+    latched++;
+  }
+}
+
+#define FLASH_WRSR_WIP 0x01
+#define FLASH_WRSR_WEL 0x02
+
+SPIEmuNorFlash::SPIEmuNorFlash(uint32_t size, uint32_t id)
+  : data(size, 0xFF), jedecId(id), programCycles(0), eraseCycles(0),
+    busyUntil(0), writeEnabled(false), opcode(0), count(0), address(0)
+{
+}
+
+void SPIEmuNorFlash::setBusyCycles(uint32_t program, uint32_t eraseTime)
+{
+  programCycles = program;
+  eraseCycles = eraseTime;
+}
+
+bool SPIEmuNorFlash::busy() const
+{
+  return SPIEmulator::cycles() < busyUntil;
+}
+
+void SPIEmuNorFlash::select()
+{
+  opcode = 0;
+  count = 0;
+  address = 0;
+}
+
+byte SPIEmuNorFlash::exchange(byte mosi)
+{
+  byte out = 0xFF;
+
+  if (count == 0) {
+    opcode = mosi;
+    if (opcode == 0x06 && !busy())
+      writeEnabled = true;
+    else if (opcode == 0x04 && !busy())
+      writeEnabled = false;
+    count = 1;
+    return out;
+  }
+
+  switch (opcode) {
+  case 0x9F:
+    if (count <= 3)
+      out = jedecId >> (8 * (3 - count));
+    break;
+  case 0x05:
+    out = (busy() ? FLASH_WRSR_WIP : 0) | (writeEnabled ? FLASH_WRSR_WEL : 0);
+    break;
+  case 0x03:
+  case 0x0B:
+  case 0x02:
+  case 0x20:
+  case 0xD8:
+    if (count <= 3) {
+      address = (address << 8) | mosi;
+    } else if (opcode == 0x03 || (opcode == 0x0B && count > 4)) {
+      if (!busy())
+        out = data[address % data.size()];
+      address++;
+    } else if (opcode == 0x02 && writeEnabled && !busy()) {
+      data[address % data.size()] &= mosi;
+      address = (address & ~0xFFUL) | ((address + 1) & 0xFF);
+    }
+    break;
+  }
+  count++;
+  return out;
+}
+
+void SPIEmuNorFlash::erase(uint32_t addr, uint32_t len)
+{
+  addr &= ~(len - 1);
+  for (uint32_t i = 0; i < len && addr + i < data.size(); i++)
+    data[addr + i] = 0xFF;
+}
+
+// Program and erase commands take effect when CS rises.
+void SPIEmuNorFlash::deselect()
+{
+  if (!writeEnabled || busy())
+    return;
+
+  uint32_t duration;
+  if (opcode == 0x02 && count > 4) {
+    duration = programCycles;
+  } else if (opcode == 0x20 && count >= 4) {
+    erase(address, 4096);
+    duration = eraseCycles;
+  } else if (opcode == 0xD8 && count >= 4) {
+    erase(address, 65536);
+    duration = eraseCycles;
+  } else if ((opcode == 0xC7 || opcode == 0x60) && count == 1) {
+    erase(0, data.size());
+    duration = eraseCycles;
+  } else {
+    return;
+  }
+
+  writeEnabled = false;
+  busyUntil = SPIEmulator::cycles() + duration;
+}
+
+#define SD_R1_IDLE 0x01
+#define SD_R1_ILLEGAL 0x04
+#define SD_R1_PARAMETER 0x40
+#define SD_BLOCK 512
+
+SPIEmuSDCard::SPIEmuSDCard(uint32_t blocks)
+  : data(blocks * SD_BLOCK, 0x00), outputHead(0), frameLength(0),
+    idle(true), appCommand(false), initPolls(2), state(WAIT_COMMAND),
+    writeAddress(0), received(0)
+{
+}
+
+byte SPIEmuSDCard::exchange(byte mosi)
+{
+  byte out = 0xFF;
+  if (outputHead < output.size()) {
+    out = output[outputHead++];
+    if (outputHead == output.size()) {
+      output.clear();
+      outputHead = 0;
+    }
+  }
+
+  switch (state) {
+  case WAIT_COMMAND:
+    // Commands start with 01 in the top bits; idle 0xFF clocks are ignored.
+    if (frameLength == 0 && (mosi & 0xC0) != 0x40)
+      break;
+    frame[frameLength++] = mosi;
+    if (frameLength == 6) {
+      frameLength = 0;
+      command();
+    }
+    break;
+  case WAIT_TOKEN:
+    if (mosi == 0xFE) {
+      state = RECEIVE_BLOCK;
+      received = 0;
+    }
+    break;
+  case RECEIVE_BLOCK:
+    if (received < SD_BLOCK)
+      data[writeAddress * SD_BLOCK + received] = mosi;
+    if (++received == SD_BLOCK + 2) {
+      queue(0x05);  // data accepted
+      queue(0x00);  // busy while programming
+      state = WAIT_COMMAND;
+    }
+    break;
+  }
+  return out;
+}
+
+void SPIEmuSDCard::command()
+{
+  uint8_t cmd = frame[0] & 0x3F;
+  uint32_t arg = ((uint32_t)frame[1] << 24) | ((uint32_t)frame[2] << 16) |
+                 ((uint32_t)frame[3] << 8) | frame[4];
+  uint32_t blocks = data.size() / SD_BLOCK;
+  bool app = appCommand;
+  appCommand = false;
+
+  queue(0xFF);  // NCR: one idle byte before the response
+  byte r1 = idle ? SD_R1_IDLE : 0x00;
+
+  if (app && cmd == 41) {
+    if (initPolls)
+      initPolls--;
+    else
+      idle = false;
+    queue(idle ? SD_R1_IDLE : 0x00);
+    return;
+  }
+
+  switch (cmd) {
+  case 0:
+    idle = true;
+    initPolls = 2;
+    queue(SD_R1_IDLE);
+    break;
+  case 8:
+    queue(r1);
+    queue(0x00);
+    queue(0x00);
+    queue((arg >> 8) & 0x0F);
+    queue(arg & 0xFF);
+    break;
+  case 16:
+    queue(r1);
+    break;
+  case 55:
+    appCommand = true;
+    queue(r1);
+    break;
+  case 58:
+    queue(r1);
+    queue(idle ? 0x00 : 0xC0);  // power up done, CCS (SDHC)
+    queue(0xFF);
+    queue(0x80);
+    queue(0x00);
+    break;
+  case 17:
+    if (idle || arg >= blocks) {
+      queue(r1 | SD_R1_PARAMETER);
+      break;
+    }
+    queue(0x00);
+    queue(0xFF);
+    queue(0xFE);
+    for (uint16_t i = 0; i < SD_BLOCK; i++)
+      queue(data[arg * SD_BLOCK + i]);
+    queue(0xFF);
+    queue(0xFF);
+    break;
+  case 24:
+    if (idle || arg >= blocks) {
+      queue(r1 | SD_R1_PARAMETER);
+      break;
+    }
+    queue(0x00);
+    writeAddress = arg;
+    state = WAIT_TOKEN;
+    break;
+  default:
+    queue(r1 | SD_R1_ILLEGAL);
+    break;
+  }
+}
+
+#endif
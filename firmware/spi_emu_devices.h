@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Virtual peripherals for the host emulation (see spi_emu.h). Each model
+// decodes frames the way the real part does and can be attached to a
+// chip-select pin with SPIEmulator::attach(), so driver code such as the
+// examples' readRegister() or digitalPotWrite() runs unchanged.
+
+#ifndef _SPI_EMU_DEVICES_H_INCLUDED
+#define _SPI_EMU_DEVICES_H_INCLUDED
+
+#include "spi.h"
+
+#include <vector>
+
+// Register-mapped sensor in the style of the SCP1000: the first byte is
+// (register << 2) with bit 1 set for writes, followed by the register's
+// bytes MSB first. Registers can be 1 to 4 bytes wide.
+class SPIEmuRegisterSensor : public SPIEmuDevice {
+public:
+  SPIEmuRegisterSensor();
+
+  void setRegister(uint8_t reg, uint32_t value, uint8_t width = 1);
+  uint32_t getRegister(uint8_t reg) const { return values[reg & 0x3F]; }
+  // Optional data-ready output, driven through the emulated pin state.
+  void setDataReadyPin(uint8_t pin);
+  void setDataReady(bool ready);
+
+  virtual void select();
+  virtual byte exchange(byte mosi);
+
+protected:
+  // Called after a complete register write or read.
+  virtual void written(uint8_t reg, uint32_t value) { (void)reg; (void)value; }
+  virtual void read(uint8_t reg) { (void)reg; }
+
+private:
+  uint32_t values[64];
+  uint8_t widths[64];
+  int16_t dataReadyPin;
+  bool command;
+  bool writing;
+  uint8_t reg;
+  uint8_t index;
+  uint32_t incoming;
+};
+
+// SCP1000 register behaviour used by the BarometricPressureSensor
+// example: writing an acquisition mode to OPERATION latches the next
+// sample and raises DRDY.
+class SPIEmuSCP1000 : public SPIEmuRegisterSensor {
+public:
+  SPIEmuSCP1000(uint8_t dataReadyPin);
+  void setSample(uint16_t temperature, uint32_t pressure);
+
+protected:
+  virtual void written(uint8_t reg, uint32_t value);
+  virtual void read(uint8_t reg);
+
+private:
+  uint16_t temperature;
+  uint32_t pressure;
+};
+
+// AD5206 six channel digital potentiometer: the last 11 bits clocked in
+// before CS rises are the 3-bit address and the 8-bit wiper value.
+class SPIEmuDigitalPot : public SPIEmuDevice {
+public:
+  SPIEmuDigitalPot();
+  uint8_t wiper(uint8_t channel) const { return wipers[channel % 6]; }
+  uint32_t updates() const { return latched; }
+
+  virtual void select();
+  virtual byte exchange(byte mosi);
+  virtual void deselect();
+
+private:
+  uint8_t wipers[6];
+  uint16_t shift;
+  uint8_t bits;
+  uint32_t latched;
+};
+
+// Serial NOR flash with the common 25-series command set: READ, FAST_READ,
+// RDID, RDSR, WREN/WRDI, PAGE_PROGRAM, 4K/64K and chip erase. Program and
+// erase keep WIP set for a configurable number of CPU cycles.
+class SPIEmuNorFlash : public SPIEmuDevice {
+public:
+  SPIEmuNorFlash(uint32_t size, uint32_t jedecId = 0xEF4018);
+
+  std::vector<byte> &memory() { return data; }
+  void setBusyCycles(uint32_t program, uint32_t erase);
+
+  virtual void select();
+  virtual byte exchange(byte mosi);
+  virtual void deselect();
+
+private:
+  bool busy() const;
+  void erase(uint32_t addr, uint32_t len);
+
+  std::vector<byte> data;
+  uint32_t jedecId;
+  uint32_t programCycles;
+  uint32_t eraseCycles;
+  uint64_t busyUntil;
+  bool writeEnabled;
+
+  byte opcode;
+  uint32_t count;
+  uint32_t address;
+};
+
+// SD card in SPI mode, SDHC flavour (block addressing): CMD0, CMD8, CMD55
+// + ACMD41, CMD58, CMD16, CMD17 and CMD24. Anything else answers
+// "illegal command".
+class SPIEmuSDCard : public SPIEmuDevice {
+public:
+  SPIEmuSDCard(uint32_t blocks);
+
+  std::vector<byte> &memory() { return data; }
+
+  virtual byte exchange(byte mosi);
+
+private:
+  void command();
+  void queue(byte value) { output.push_back(value); }
+
+  std::vector<byte> data;
+  std::vector<byte> output;
+  size_t outputHead;
+  byte frame[6];
+  uint8_t frameLength;
+  bool idle;
+  bool appCommand;
+  uint8_t initPolls;
+
+  enum { WAIT_COMMAND, WAIT_TOKEN, RECEIVE_BLOCK } state;
+  uint32_t writeAddress;
+  uint16_t received;
+};
+
+#endif
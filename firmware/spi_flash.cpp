@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_flash.h"
+
+#define SPI_FLASH_NO_LINE 0xFFFFFFFFUL
+
+SPIFlashReader::SPIFlashReader(uint8_t pin)
+  : csPin(pin), continuous(false), streaming(false),
+    streamNext(SPI_FLASH_NO_LINE), lastMiss(SPI_FLASH_NO_LINE)
+{
+  invalidate();
+}
+
+void SPIFlashReader::begin()
+{
+  spiPinHigh(csPin);
+  spiPinOutput(csPin);
+}
+
+void SPIFlashReader::invalidate()
+{
+  for (uint8_t set = 0; set < SPI_FLASH_SETS; set++) {
+    mru[set] = 0;
+    for (uint8_t way = 0; way < SPI_FLASH_WAYS; way++)
+      lines[set][way].tag = SPI_FLASH_NO_LINE;
+  }
+}
+
+void SPIFlashReader::setContinuous(bool enable)
+{
+  continuous = enable;
+  if (!enable)
+    release();
+}
+
+void SPIFlashReader::release()
+{
+  if (!streaming)
+    return;
+  spiPinHigh(csPin);
+  SPI.endTransaction();
+  streaming = false;
+}
+
+// Clocks len bytes starting at addr into buf. An open stream already
+// positioned at addr is continued; otherwise a new READ is issued.
+void SPIFlashReader::stream(uint32_t addr, void *buf, size_t len)
+{
+  if (!streaming || streamNext != addr) {
+    release();
+    SPI.beginTransaction();
+    spiPinLow(csPin);
+    byte header[4] = {
+      SPI_FLASH_CMD_READ, (byte)(addr >> 16), (byte)(addr >> 8), (byte)addr
+    };
+    SPI.transfer(header, NULL, sizeof(header));
+    streaming = true;
+  }
+  SPI.transfer(NULL, buf, len);
+  streamNext = addr + len;
+  if (!continuous)
+    release();
+}
+
+SPIFlashReader::Line *SPIFlashReader::lookup(uint32_t line)
+{
+  uint8_t set = line & (SPI_FLASH_SETS - 1);
+  if (lines[set][mru[set]].tag == line)
+    return &lines[set][mru[set]];
+  for (uint8_t way = 0; way < SPI_FLASH_WAYS; way++) {
+    if (lines[set][way].tag == line) {
+      mru[set] = way;
+      return &lines[set][way];
+    }
+  }
+  return NULL;
+}
+
+SPIFlashReader::Line *SPIFlashReader::fill(uint32_t line)
+{
+  // A miss right after the previous one looks like a sequential scan:
+  // pull in the following lines while the command is already paid for.
+  // The lines go out under a single READ, so the stream stays open for
+  // the whole burst even when continuous mode is off.
+  bool sequential = lastMiss != SPI_FLASH_NO_LINE && line == lastMiss + 1;
+  uint8_t count = sequential ? 1 + SPI_FLASH_READAHEAD : 1;
+  if (count > SPI_FLASH_SETS)
+    count = SPI_FLASH_SETS;
+  bool wasContinuous = continuous;
+  continuous = true;
+  Line *first = NULL;
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (i > 0 && lookup(line + i)) {
+      count = i;
+      break;
+    }
+    uint8_t set = (line + i) & (SPI_FLASH_SETS - 1);
+    uint8_t way = (mru[set] + 1) % SPI_FLASH_WAYS;
+    Line *victim = &lines[set][way];
+    victim->tag = SPI_FLASH_NO_LINE;
+    stream((line + i) * SPI_FLASH_LINE_SIZE, victim->data, SPI_FLASH_LINE_SIZE);
+    victim->tag = line + i;
+    if (i == 0) {
+      mru[set] = way;
+      first = victim;
+    }
+  }
+  continuous = wasContinuous;
+  if (!continuous)
+    release();
+  lastMiss = line + count - 1;
+  return first;
+}
+
+void SPIFlashReader::read(uint32_t addr, void *buf, size_t len)
+{
+  byte *out = (byte *)buf;
+
+  if (len >= 2 * SPI_FLASH_LINE_SIZE) {
+    stream(addr, out, len);
+    return;
+  }
+
+  while (len) {
+    uint32_t line = addr / SPI_FLASH_LINE_SIZE;
+    uint8_t offset = addr & (SPI_FLASH_LINE_SIZE - 1);
+    size_t chunk = SPI_FLASH_LINE_SIZE - offset;
+    if (chunk > len)
+      chunk = len;
+
+    Line *cached = lookup(line);
+    if (!cached)
+      cached = fill(line);
+    memcpy(out, cached->data + offset, chunk);
+
+    out += chunk;
+    addr += chunk;
+    len -= chunk;
+  }
+}
+
+byte SPIFlashReader::operator[](uint32_t addr)
+{
+  uint32_t line = addr / SPI_FLASH_LINE_SIZE;
+  Line *cached = lookup(line);
+  if (!cached)
+    cached = fill(line);
+  return cached->data[addr & (SPI_FLASH_LINE_SIZE - 1)];
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_FLASH_H_INCLUDED
+#define _SPI_FLASH_H_INCLUDED
+
+#include "spi.h"
+
+// Cache geometry. Sets and line size must be powers of two.
+#ifndef SPI_FLASH_LINE_SIZE
+#define SPI_FLASH_LINE_SIZE 16
+#endif
+#ifndef SPI_FLASH_SETS
+#define SPI_FLASH_SETS 4
+#endif
+#ifndef SPI_FLASH_WAYS
+#define SPI_FLASH_WAYS 2
+#endif
+// Extra lines fetched when a miss follows the previous one sequentially.
+#ifndef SPI_FLASH_READAHEAD
+#define SPI_FLASH_READAHEAD 2
+#endif
+
+#define SPI_FLASH_CMD_READ 0x03
+
+// Read-only view of an external NOR flash as a byte-addressable region,
+// much like pgm_read_byte() does for internal flash. Small reads are
+// served from a set-associative line cache; reads of two lines or more
+// are streamed directly into the caller's buffer.
+class SPIFlashReader {
+public:
+  SPIFlashReader(uint8_t csPin);
+
+  void begin();
+  void read(uint32_t addr, void *buf, size_t len);
+  byte operator[](uint32_t addr);
+
+  // In continuous mode chip select stays asserted after a fetch, so the
+  // next sequential line is clocked out without a new command and
+  // address. The bus is held until release() is called.
+  void setContinuous(bool enable);
+  void release();
+  void invalidate();
+
+private:
+  struct Line {
+    uint32_t tag;
+    byte data[SPI_FLASH_LINE_SIZE];
+  };
+
+  Line *lookup(uint32_t line);
+  Line *fill(uint32_t line);
+  void stream(uint32_t addr, void *buf, size_t len);
+
+  uint8_t csPin;
+  bool continuous;
+  bool streaming;
+  uint32_t streamNext;
+  uint32_t lastMiss;
+  uint8_t mru[SPI_FLASH_SETS];
+  Line lines[SPI_FLASH_SETS][SPI_FLASH_WAYS];
+};
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi.h"
+
+// The library never defines the SPI vector itself: library objects are
+// linked whether used or not, and a sketch with its own
+// ISR(SPI_STC_vect) must keep linking. Handlers attached here run from
+// the vector that SPI_INTERRUPT_VECTOR puts in the sketch.
+static void (*volatile spiInterruptHandler)(void);
+
+void SPIClass::attachInterrupt(void (*handler)(void))
+{
+  spiInterruptHandler = handler;
+#ifdef SPI_EMULATION
+  SPIEmulator::setInterruptHandler(handler);
+#endif
+  SPCR |= _BV(SPIE);
+}
+
+void SPIClass::handleInterrupt()
+{
+  void (*handler)(void) = spiInterruptHandler;
+  if (handler)
+    handler();
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_link.h"
+
+SPILinkMaster::SPILinkMaster(uint8_t cs, uint8_t ready, SPISettings s)
+  : settings(s), csPin(cs), readyPin(ready), byteDelay(4), nextSeq(0),
+    head(0), count(0), sent(0), lastAck(0)
+{
+}
+
+void SPILinkMaster::begin()
+{
+  spiPinHigh(csPin);
+  spiPinOutput(csPin);
+  spiPinInput(readyPin);
+  SPI.begin();
+  lastAck = millis();
+}
+
+bool SPILinkMaster::send(const void *data, uint8_t length)
+{
+  if (length > SPI_LINK_MAX_PAYLOAD)
+    return false;
+  if (count == SPI_LINK_WINDOW)
+    poll();
+  if (count == SPI_LINK_WINDOW)
+    return false;
+
+  Frame &frame = window[(head + count) % SPI_LINK_WINDOW];
+  frame.seq = nextSeq++;
+  frame.length = length;
+  memcpy(frame.data, data, length);
+  if (count++ == 0)
+    lastAck = millis();
+  pump();
+  return true;
+}
+
+void SPILinkMaster::poll()
+{
+  if (count == 0)
+    return;
+
+  // A lone status byte, not a frame start, so the slave stays in HUNT.
+  if (!spiPinRead(readyPin) || sent) {
+    SPI.beginTransaction(settings);
+    spiPinLow(csPin);
+    acknowledge(exchange(0x00));
+    spiPinHigh(csPin);
+    SPI.endTransaction();
+  }
+
+  // Go back N: the slave drops anything after a lost frame, so resend
+  // the whole window from the oldest unacked one.
+  if (count && sent && millis() - lastAck >= SPI_LINK_RETRY_MS) {
+    sent = 0;
+    lastAck = millis();
+  }
+  pump();
+}
+
+bool SPILinkMaster::flush(unsigned long timeoutMs)
+{
+  unsigned long start = millis();
+  while (count) {
+    if (millis() - start >= timeoutMs)
+      return false;
+    poll();
+  }
+  return true;
+}
+
+// Sends queued frames back to back while the slave has room. Frames go
+// out strictly in order; one the slave is not ready for holds back the
+// rest rather than have them rejected as out of sequence.
+void SPILinkMaster::pump()
+{
+  while (sent < count && !spiPinRead(readyPin))
+    transmit(window[(head + sent++) % SPI_LINK_WINDOW]);
+}
+
+void SPILinkMaster::transmit(const Frame &frame)
+{
+  uint16_t crc = spiLinkCrc(spiLinkCrc(0xFFFF, frame.seq), frame.length);
+  for (uint8_t i = 0; i < frame.length; i++)
+    crc = spiLinkCrc(crc, frame.data[i]);
+
+  SPI.beginTransaction(settings);
+  spiPinLow(csPin);
+  // The slave's answer to the start byte is its current ack.
+  acknowledge(exchange(SPI_LINK_SOF));
+  exchange(frame.seq);
+  exchange(frame.length);
+  for (uint8_t i = 0; i < frame.length; i++)
+    exchange(frame.data[i]);
+  exchange(crc >> 8);
+  exchange(crc);
+  spiPinHigh(csPin);
+  SPI.endTransaction();
+}
+
+// The slave reports the next sequence number it expects. Anything that
+// does not fall inside the window (a floating MISO, a slave that has
+// not started yet) is ignored.
+void SPILinkMaster::acknowledge(uint8_t next)
+{
+  if (count == 0)
+    return;
+  uint8_t acked = next - window[head].seq;
+  if (acked == 0 || acked > count)
+    return;
+  // After a go-back the slave may ack frames from the earlier pass.
+  head = (head + acked) % SPI_LINK_WINDOW;
+  count -= acked;
+  sent = acked < sent ? sent - acked : 0;
+  lastAck = millis();
+}
+
+byte SPILinkMaster::exchange(byte value)
+{
+  byte in = SPI.transfer(value);
+  if (byteDelay)
+    delayMicroseconds(byteDelay);
+  return in;
+}
+
+uint8_t SPILinkSlave::readyPin;
+uint8_t SPILinkSlave::state = SPILinkSlave::HUNT;
+uint8_t SPILinkSlave::expected = 0;
+uint8_t SPILinkSlave::seq;
+uint8_t SPILinkSlave::length;
+uint8_t SPILinkSlave::position;
+uint16_t SPILinkSlave::crc;
+uint16_t SPILinkSlave::received;
+bool SPILinkSlave::room;
+uint8_t SPILinkSlave::lengths[SPI_LINK_RX_FRAMES];
+byte SPILinkSlave::frames[SPI_LINK_RX_FRAMES][SPI_LINK_MAX_PAYLOAD];
+volatile uint8_t SPILinkSlave::head = 0;
+volatile uint8_t SPILinkSlave::tail = 0;
+
+void SPILinkSlave::begin(uint8_t pin)
+{
+  readyPin = pin;
+  spiPinLow(readyPin);
+  spiPinOutput(readyPin);
+  SPIClass::beginSlave();
+  SPDR = expected;
+  SPIClass::attachInterrupt(onInterrupt);
+  SPIClass::enableSelectInterrupt(true);
+}
+
+// Whatever was being parsed when SS rose is over. The pin change vector
+// outranks the SPI one, so the frame's last byte is taken first.
+void SPILinkSlave::selectChanged()
+{
+  if (!spiPinRead(SS))
+    return;
+  if (SPSR & _BV(SPIF))
+    onInterrupt();
+  state = HUNT;
+}
+
+int SPILinkSlave::read(void *buffer, uint8_t size)
+{
+  if (head == tail)
+    return -1;
+  SPI_MEMORY_BARRIER();
+
+  uint8_t slot = head % SPI_LINK_RX_FRAMES;
+  uint8_t n = lengths[slot];
+  memcpy(buffer, frames[slot], n < size ? n : size);
+  // The handler raises the line when the ring fills; keep it from
+  // doing so between freeing the slot and lowering it here.
+  SPI_MEMORY_BARRIER();
+  uint8_t oldSREG = SREG;
+  noInterrupts();
+  head = head + 1;
+  spiPinLow(readyPin);
+  SREG = oldSREG;
+  return n;
+}
+
+// One call per byte clocked in by the master. Bytes of a frame that
+// cannot be stored are still parsed so the CRC and framing stay in
+// step, but the frame is not acked and the master sends it again.
+void SPILinkSlave::onInterrupt()
+{
+  byte in = SPDR;
+  uint8_t slot = tail % SPI_LINK_RX_FRAMES;
+
+  switch (state) {
+  case HUNT:
+    if (in == SPI_LINK_SOF)
+      state = SEQ;
+    break;
+  case SEQ:
+    seq = in;
+    // Decided once per frame: read() may free a slot halfway through.
+    room = (uint8_t)(tail - head) < SPI_LINK_RX_FRAMES;
+    crc = spiLinkCrc(0xFFFF, in);
+    state = LENGTH;
+    break;
+  case LENGTH:
+    if (in > SPI_LINK_MAX_PAYLOAD) {
+      state = HUNT;
+      break;
+    }
+    length = in;
+    position = 0;
+    crc = spiLinkCrc(crc, in);
+    state = length ? PAYLOAD : CRC_HIGH;
+    break;
+  case PAYLOAD:
+    if (room)
+      frames[slot][position] = in;
+    crc = spiLinkCrc(crc, in);
+    if (++position == length)
+      state = CRC_HIGH;
+    break;
+  case CRC_HIGH:
+    received = (uint16_t)in << 8;
+    state = CRC_LOW;
+    break;
+  case CRC_LOW:
+    received |= in;
+    state = HUNT;
+    // Duplicates of acked frames and frames after a gap are dropped;
+    // the ack below tells the master where to resume.
+    if (received != crc || seq != expected || !room)
+      break;
+    lengths[slot] = length;
+    SPI_MEMORY_BARRIER();
+    tail = tail + 1;
+    expected++;
+    if ((uint8_t)(tail - head) == SPI_LINK_RX_FRAMES)
+      spiPinHigh(readyPin);
+    break;
+  }
+
+  SPDR = expected;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Framed board-to-board link. The master sends one frame per CS window:
+//
+//   0x7E  seq  len  payload[len]  crc16 (MSB first)
+//
+// with a CRC-16/CCITT over seq, len and the payload. On every byte the
+// slave answers with the sequence number it expects next, which acks
+// all frames before it, so the master can keep up to SPI_LINK_WINDOW
+// frames in flight and go back to the oldest one when acks stop coming.
+// The slave holds its ready line low while it has room for a frame.
+
+#ifndef _SPI_LINK_H_INCLUDED
+#define _SPI_LINK_H_INCLUDED
+
+#include "spi.h"
+
+#ifndef SPI_LINK_MAX_PAYLOAD
+#define SPI_LINK_MAX_PAYLOAD 32
+#endif
+#ifndef SPI_LINK_WINDOW
+#define SPI_LINK_WINDOW 4
+#endif
+// Frames the slave can hold until read(). Must be a power of two: the
+// ring indices are free-running bytes taken modulo this.
+#ifndef SPI_LINK_RX_FRAMES
+#define SPI_LINK_RX_FRAMES 2
+#endif
+#if SPI_LINK_RX_FRAMES & (SPI_LINK_RX_FRAMES - 1) || SPI_LINK_RX_FRAMES > 128
+#error "SPI_LINK_RX_FRAMES must be a power of two no larger than 128"
+#endif
+// Milliseconds without an ack before unacked frames are sent again.
+#ifndef SPI_LINK_RETRY_MS
+#define SPI_LINK_RETRY_MS 20
+#endif
+
+#define SPI_LINK_SOF 0x7E
+
+inline uint16_t spiLinkCrc(uint16_t crc, byte data)
+{
+  uint8_t x = (crc >> 8) ^ data;
+  x ^= x >> 4;
+  return (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+}
+
+class SPILinkMaster {
+public:
+  SPILinkMaster(uint8_t csPin, uint8_t readyPin, SPISettings settings);
+
+  void begin();
+  // The slave reloads SPDR from its interrupt handler, so bytes need
+  // some spacing at fast clocks. Defaults to 4us.
+  void setByteDelay(uint8_t us) { byteDelay = us; }
+
+  // Queues a frame and sends it as soon as the slave is ready. Returns
+  // false if the payload is too long or the window is full.
+  bool send(const void *data, uint8_t length);
+  // Collects acks, resends on timeout and sends queued frames.
+  void poll();
+  // Frames not yet acked by the slave.
+  uint8_t pending() const { return count; }
+  bool flush(unsigned long timeoutMs);
+
+private:
+  struct Frame {
+    uint8_t seq;
+    uint8_t length;
+    byte data[SPI_LINK_MAX_PAYLOAD];
+  };
+
+  void pump();
+  void transmit(const Frame &frame);
+  void acknowledge(uint8_t next);
+  byte exchange(byte value);
+
+  SPISettings settings;
+  uint8_t csPin;
+  uint8_t readyPin;
+  uint8_t byteDelay;
+  uint8_t nextSeq;
+  uint8_t head;   // oldest unacked frame
+  uint8_t count;  // frames in the window
+  uint8_t sent;   // of those, how many are on the wire
+  unsigned long lastAck;
+  Frame window[SPI_LINK_WINDOW];
+};
+
+// The receiving side runs from the SPI interrupt; there is only one
+// peripheral so all state is static. Completed frames go into a small
+// ring that read() drains. The sketch needs SPI_INTERRUPT_VECTOR, and
+// SPI_LINK_SELECT_VECTOR (or a pin change handler of its own calling
+// selectChanged()) so that a frame cut short by the master is dropped
+// at SS rise instead of swallowing the start of the next one.
+class SPILinkSlave {
+public:
+  static void begin(uint8_t readyPin);
+  static void selectChanged();
+
+  static uint8_t available() { return (uint8_t)(tail - head); }
+  // Copies the oldest frame into buffer and returns its length, or -1
+  // if there is none. A longer frame is truncated to size.
+  static int read(void *buffer, uint8_t size);
+
+private:
+  enum { HUNT, SEQ, LENGTH, PAYLOAD, CRC_HIGH, CRC_LOW };
+
+  static void onInterrupt();
+
+  static uint8_t readyPin;
+  static uint8_t state;
+  static uint8_t expected;
+  static uint8_t seq;
+  static uint8_t length;
+  static uint8_t position;
+  static uint16_t crc;
+  static uint16_t received;
+  static bool room;
+  static uint8_t lengths[SPI_LINK_RX_FRAMES];
+  static byte frames[SPI_LINK_RX_FRAMES][SPI_LINK_MAX_PAYLOAD];
+  // Free-running indices: the handler only moves tail, read() only
+  // moves head.
+  static volatile uint8_t head;
+  static volatile uint8_t tail;
+};
+
+#ifdef PCINT0_vect
+#define SPI_LINK_SELECT_VECTOR ISR(PCINT0_vect) { SPILinkSlave::selectChanged(); }
+#else
+#define SPI_LINK_SELECT_VECTOR
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_multiio.h"
+
+static uint8_t bitIndex(uint8_t mask)
+{
+  uint8_t index = 0;
+  while (mask > 1) {
+    mask >>= 1;
+    index++;
+  }
+  return index;
+}
+
+SPIMultiIO::SPIMultiIO(uint8_t cs, uint8_t sckPin, uint8_t io0Pin)
+  : csPin(cs), width(SPI_IO_SINGLE)
+{
+  uint8_t port = digitalPinToPort(sckPin);
+  clkOut = portOutputRegister(port);
+  clkDir = portModeRegister(port);
+  sckMask = digitalPinToBitMask(sckPin);
+
+  port = digitalPinToPort(io0Pin);
+  ioOut = portOutputRegister(port);
+  ioIn = portInputRegister(port);
+  ioDir = portModeRegister(port);
+  ioShift = bitIndex(digitalPinToBitMask(io0Pin));
+}
+
+SPIMultiIO::SPIMultiIO(uint8_t cs,
+                       volatile uint8_t *clockOut, volatile uint8_t *clockDir,
+                       uint8_t clockMask,
+                       volatile uint8_t *dataOut, volatile uint8_t *dataIn,
+                       volatile uint8_t *dataDir, uint8_t io0Bit)
+  : csPin(cs), clkOut(clockOut), clkDir(clockDir), sckMask(clockMask),
+    ioOut(dataOut), ioIn(dataIn), ioDir(dataDir), ioShift(io0Bit),
+    width(SPI_IO_SINGLE)
+{
+}
+
+void SPIMultiIO::begin()
+{
+  spiPinHigh(csPin);
+  spiPinOutput(csPin);
+  *clkOut &= ~sckMask;
+  *clkDir |= sckMask;
+  phase(SPI_IO_SINGLE, true);
+}
+
+void SPIMultiIO::end()
+{
+  *ioDir &= ~(0x0F << ioShift);
+  *clkDir &= ~sckMask;
+}
+
+// Sets line directions for the next phase and caches what the shift
+// loops need, so each clock is one port store plus the SCK pulse.
+void SPIMultiIO::phase(uint8_t lines, bool output)
+{
+  uint8_t all = 0x0F << ioShift;
+  uint8_t held = (lines < SPI_IO_QUAD) ? (0x0C << ioShift) : 0;
+  uint8_t driven;
+
+  if (lines == SPI_IO_SINGLE)
+    driven = 0x01 << ioShift;
+  else
+    driven = output ? (((1 << lines) - 1) << ioShift) : 0;
+
+  *ioOut = (*ioOut & ~all) | held;
+  *ioDir = (*ioDir & ~all) | driven | held;
+
+  width = lines;
+  outBase = *ioOut;
+  inShift = (lines == SPI_IO_SINGLE) ? ioShift + 1 : ioShift;
+  inMask = (1 << lines) - 1;
+}
+
+// Mode 0: data is set up while SCK is low and sampled on the rising edge.
+void SPIMultiIO::shiftOut(byte value)
+{
+  for (int8_t shift = 8 - width; shift >= 0; shift -= width) {
+    *ioOut = outBase | (((value >> shift) & inMask) << ioShift);
+    *clkOut |= sckMask;
+    *clkOut &= ~sckMask;
+  }
+}
+
+byte SPIMultiIO::shiftIn()
+{
+  byte value = 0;
+  for (uint8_t bits = 0; bits < 8; bits += width) {
+    *clkOut |= sckMask;
+    value = (value << width) | ((*ioIn >> inShift) & inMask);
+    *clkOut &= ~sckMask;
+  }
+  return value;
+}
+
+void SPIMultiIO::header(const SPIMultiIOCommand &cmd)
+{
+  spiPinLow(csPin);
+
+  phase(cmd.commandWidth, true);
+  shiftOut(cmd.command);
+
+  if (cmd.addressBytes) {
+    phase(cmd.addressWidth, true);
+    for (int8_t i = cmd.addressBytes - 1; i >= 0; i--)
+      shiftOut(cmd.address >> (8 * i));
+  }
+
+  if (cmd.dummyCycles) {
+    phase(cmd.dataWidth, false);
+    for (uint8_t i = 0; i < cmd.dummyCycles; i++) {
+      *clkOut |= sckMask;
+      *clkOut &= ~sckMask;
+    }
+  }
+}
+
+void SPIMultiIO::read(const SPIMultiIOCommand &cmd, void *buf, size_t len)
+{
+  byte *in = (byte *)buf;
+
+  header(cmd);
+  phase(cmd.dataWidth, false);
+  while (len--)
+    *in++ = shiftIn();
+  spiPinHigh(csPin);
+  phase(SPI_IO_SINGLE, true);
+}
+
+void SPIMultiIO::write(const SPIMultiIOCommand &cmd, const void *buf, size_t len)
+{
+  const byte *out = (const byte *)buf;
+
+  header(cmd);
+  phase(cmd.dataWidth, true);
+  while (len--)
+    shiftOut(*out++);
+  spiPinHigh(csPin);
+  phase(SPI_IO_SINGLE, true);
+}
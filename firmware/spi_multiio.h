@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_MULTIIO_H_INCLUDED
+#define _SPI_MULTIIO_H_INCLUDED
+
+#include "spi.h"
+
+#define SPI_IO_SINGLE 1
+#define SPI_IO_DUAL 2
+#define SPI_IO_QUAD 4
+
+// Common NOR flash read commands.
+#define SPI_MULTIIO_FAST_READ 0x0B        // 1-1-1, 8 dummy clocks
+#define SPI_MULTIIO_READ_DUAL_OUT 0x3B    // 1-1-2, 8 dummy clocks
+#define SPI_MULTIIO_READ_QUAD_OUT 0x6B    // 1-1-4, 8 dummy clocks
+#define SPI_MULTIIO_READ_QUAD_IO 0xEB     // 1-4-4, mode byte + 4 dummy clocks
+
+// One flash/display command: each phase can run on 1, 2 or 4 lines.
+// Mode bits (e.g. 0xFF for READ_QUAD_IO) are sent as an extra, lowest
+// address byte.
+struct SPIMultiIOCommand {
+  uint8_t command;
+  uint8_t commandWidth;
+  uint32_t address;
+  uint8_t addressBytes;
+  uint8_t addressWidth;
+  uint8_t dummyCycles;
+  uint8_t dataWidth;
+};
+
+// Dual/quad I/O master. The AVR SPI peripheral only shifts one bit per
+// clock, so this drives the lines directly through the port registers.
+// IO0..IO3 must be four consecutive bits of one port; IO1 doubles as
+// MISO and IO2/IO3 (WP#/HOLD#) are held high in single and dual phases.
+// Other bits of the data port are sampled once per phase, so interrupt
+// handlers must not change them while a command runs.
+class SPIMultiIO {
+public:
+  SPIMultiIO(uint8_t csPin, uint8_t sckPin, uint8_t io0Pin);
+  // Direct register form, also usable against plain memory on a host.
+  SPIMultiIO(uint8_t csPin,
+             volatile uint8_t *clkOut, volatile uint8_t *clkDir, uint8_t sckMask,
+             volatile uint8_t *ioOut, volatile uint8_t *ioIn,
+             volatile uint8_t *ioDir, uint8_t io0Bit);
+
+  void begin();
+  void end();
+
+  void read(const SPIMultiIOCommand &cmd, void *buf, size_t len);
+  void write(const SPIMultiIOCommand &cmd, const void *buf, size_t len);
+
+private:
+  void header(const SPIMultiIOCommand &cmd);
+  void phase(uint8_t width, bool output);
+  void shiftOut(byte value);
+  byte shiftIn();
+
+  uint8_t csPin;
+  volatile uint8_t *clkOut;
+  volatile uint8_t *clkDir;
+  uint8_t sckMask;
+  volatile uint8_t *ioOut;
+  volatile uint8_t *ioIn;
+  volatile uint8_t *ioDir;
+  uint8_t ioShift;
+
+  // State of the current phase.
+  uint8_t width;
+  uint8_t outBase;
+  uint8_t inShift;
+  uint8_t inMask;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_ninebit.h"
+
+SPINineBit::SPINineBit()
+  : pending(0), bits(0), words(0), shifting(false)
+{
+}
+
+// Waits for the byte on the wire only now, after the caller has packed
+// this one, so packing overlaps the shift.
+void SPINineBit::emit(byte value)
+{
+  if (shifting) {
+    while (!(SPSR & _BV(SPIF)))
+      ;
+  }
+  SPDR = value;
+  shifting = true;
+}
+
+// At most 7 bits are left over from earlier words, so with the new 9
+// the accumulator never needs more than 16.
+void SPINineBit::write(uint16_t word)
+{
+  pending = (pending << 9) | (word & 0x1FF);
+  bits += 9;
+  words = (words + 1) & 7;
+
+  bits -= 8;
+  emit(pending >> bits);
+  if (bits >= 8) {
+    bits -= 8;
+    emit(pending >> bits);
+  }
+  pending &= (1 << bits) - 1;
+}
+
+void SPINineBit::write(const uint16_t *list, size_t count)
+{
+  while (count--)
+    write(*list++);
+}
+
+void SPINineBit::data(const void *buf, size_t len)
+{
+  const byte *in = (const byte *)buf;
+  while (len--)
+    write(SPI_NINE_DATA | *in++);
+}
+
+void SPINineBit::align(uint16_t pad)
+{
+  while (words)
+    write(pad);
+}
+
+void SPINineBit::flush()
+{
+  if (bits) {
+    emit(pending << (8 - bits));
+    pending = 0;
+    bits = 0;
+  }
+  words = 0;
+  if (shifting) {
+    while (!(SPSR & _BV(SPIF)))
+      ;
+    (void)SPDR;
+    shifting = false;
+  }
+}
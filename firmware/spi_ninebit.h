@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_NINEBIT_H_INCLUDED
+#define _SPI_NINEBIT_H_INCLUDED
+
+#include "spi.h"
+
+// D/C bit of a 9-bit word, sent ahead of the 8 payload bits.
+#define SPI_NINE_COMMAND 0x000
+#define SPI_NINE_DATA 0x100
+// NOP command on the common 3-wire controllers (ST7735, ILI9341, ...).
+#define SPI_NINE_NOP (SPI_NINE_COMMAND | 0x00)
+
+// 9-bit words for 3-wire displays, packed MSB first into the 8-bit
+// shifter as they are written: eight words become nine bytes, so mixing
+// commands and data needs neither a D/C pin nor a CS toggle. Each byte
+// is packed while the previous one is on the wire.
+//
+//   SPI.beginTransaction(settings);
+//   digitalWrite(displayCs, LOW);
+//   SPINineBit lcd;
+//   lcd.command(0x2C);                 // memory write
+//   lcd.data(pixels, sizeof(pixels));
+//   lcd.flush();
+//   digitalWrite(displayCs, HIGH);
+//   SPI.endTransaction();
+//
+// Call flush() before raising CS. The bits that complete the last byte
+// are zero; controllers discard a partial word at CS rise, and align()
+// can pad with whole NOP words for those that do not.
+class SPINineBit {
+public:
+  SPINineBit();
+
+  void write(uint16_t word);
+  void write(const uint16_t *words, size_t count);
+  void command(byte value) { write(SPI_NINE_COMMAND | value); }
+  void data(byte value) { write(SPI_NINE_DATA | value); }
+  void data(const void *buf, size_t len);
+
+  // Pads with pad words up to the next 8-word boundary, where the
+  // stream ends on a byte boundary with no filler bits.
+  void align(uint16_t pad = SPI_NINE_NOP);
+  // Sends any remaining bits and waits for the last byte.
+  void flush();
+
+private:
+  void emit(byte value);
+
+  uint16_t pending;  // bits not yet sent, right aligned
+  uint8_t bits;      // always below 8 between calls
+  uint8_t words;     // words written modulo 8
+  bool shifting;
+};
+
+#endif
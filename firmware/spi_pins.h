@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Pin access used for the SPI pins, chip selects and handshake lines.
+// On the Spark Core (STM32F103) the pin number is looked up in a
+// constexpr table of GPIO port and bit, so with a constant pin an
+// inlined spiPinLow() is a single store to BRR instead of a trip
+// through the wiring pin map. Elsewhere these fall back to
+// digitalWrite(), digitalRead() and pinMode().
+//
+// The STM32 path is not reachable yet: the rest of the library drives
+// the AVR SPCR/SPSR/SPDR registers, which that part does not have, so
+// it only builds for AVR and the host emulation. The table is there
+// for a port of the register layer.
+//
+// Included from spi.h; not meant to be included on its own.
+
+#ifndef _SPI_PINS_H_INCLUDED
+#define _SPI_PINS_H_INCLUDED
+
+#if (defined(SPARK) || defined(STM32F10X_MD)) && !defined(SPI_EMULATION)
+#define SPI_FAST_PINS 1
+#else
+#define SPI_FAST_PINS 0
+#endif
+
+#if SPI_FAST_PINS
+
+#define SPI_GPIOA 0x40010800UL
+#define SPI_GPIOB 0x40010C00UL
+
+// CRL/CRH nibbles: MODE in bits 1:0, CNF in bits 3:2.
+#define SPI_PIN_INPUT 0x4       // floating input
+#define SPI_PIN_OUTPUT 0x3      // push-pull, 50 MHz
+#define SPI_PIN_ALTERNATE 0xB   // alternate function push-pull, 50 MHz
+
+struct SPIPinDescriptor {
+  uint32_t port;      // GPIO base, 0 for pins that do not exist
+  uint8_t bit;
+  uint8_t alternate;  // configuration for the pin's SPI role
+};
+
+// Indexed by wiring pin number: D0-D7, two unused, A0-A7, RX, TX.
+// SPI1 sits on PA4-PA7 (A2-A5) without remapping.
+static constexpr SPIPinDescriptor spiPinTable[] = {
+  { SPI_GPIOB, 7, SPI_PIN_OUTPUT },      // D0
+  { SPI_GPIOB, 6, SPI_PIN_OUTPUT },      // D1
+  { SPI_GPIOB, 5, SPI_PIN_OUTPUT },      // D2
+  { SPI_GPIOB, 4, SPI_PIN_OUTPUT },      // D3
+  { SPI_GPIOB, 3, SPI_PIN_OUTPUT },      // D4
+  { SPI_GPIOA, 15, SPI_PIN_OUTPUT },     // D5
+  { SPI_GPIOA, 14, SPI_PIN_OUTPUT },     // D6
+  { SPI_GPIOA, 13, SPI_PIN_OUTPUT },     // D7
+  { 0, 0, 0 },
+  { 0, 0, 0 },
+  { SPI_GPIOA, 0, SPI_PIN_OUTPUT },      // A0
+  { SPI_GPIOA, 1, SPI_PIN_OUTPUT },      // A1
+  { SPI_GPIOA, 4, SPI_PIN_OUTPUT },      // A2, SS
+  { SPI_GPIOA, 5, SPI_PIN_ALTERNATE },   // A3, SCK
+  { SPI_GPIOA, 6, SPI_PIN_INPUT },       // A4, MISO
+  { SPI_GPIOA, 7, SPI_PIN_ALTERNATE },   // A5, MOSI
+  { SPI_GPIOB, 0, SPI_PIN_OUTPUT },      // A6
+  { SPI_GPIOB, 1, SPI_PIN_OUTPUT },      // A7
+  { SPI_GPIOA, 3, SPI_PIN_INPUT },       // RX
+  { SPI_GPIOA, 2, SPI_PIN_OUTPUT },      // TX
+};
+
+#define SPI_PIN_COUNT (sizeof(spiPinTable) / sizeof(spiPinTable[0]))
+
+constexpr uint32_t spiPinPort(uint8_t pin)
+{
+  return pin < SPI_PIN_COUNT ? spiPinTable[pin].port : 0;
+}
+
+constexpr uint32_t spiPinMask(uint8_t pin)
+{
+  return pin < SPI_PIN_COUNT ? 1UL << spiPinTable[pin].bit : 0;
+}
+
+constexpr uint8_t spiPinAlternate(uint8_t pin)
+{
+  return pin < SPI_PIN_COUNT ? spiPinTable[pin].alternate : SPI_PIN_INPUT;
+}
+
+// Bit set/reset registers: single stores, no read-modify-write.
+inline void spiPinHigh(uint8_t pin)
+{
+  if (spiPinPort(pin))
+    *(volatile uint32_t *)(spiPinPort(pin) + 0x10) = spiPinMask(pin);
+}
+
+inline void spiPinLow(uint8_t pin)
+{
+  if (spiPinPort(pin))
+    *(volatile uint32_t *)(spiPinPort(pin) + 0x14) = spiPinMask(pin);
+}
+
+// The GPIO clocks are already enabled by the system startup code.
+inline void spiPinConfigure(uint8_t pin, uint8_t config)
+{
+  if (!spiPinPort(pin))
+    return;
+  uint8_t bit = spiPinTable[pin].bit;
+  volatile uint32_t *cr = (volatile uint32_t *)(spiPinPort(pin) + (bit < 8 ? 0x00 : 0x04));
+  uint8_t shift = (bit & 7) * 4;
+  *cr = (*cr & ~(0xFUL << shift)) | ((uint32_t)config << shift);
+}
+
+inline bool spiPinRead(uint8_t pin)
+{
+  return spiPinPort(pin) &&
+         (*(volatile uint32_t *)(spiPinPort(pin) + 0x08) & spiPinMask(pin));
+}
+
+inline void spiPinOutput(uint8_t pin) { spiPinConfigure(pin, SPI_PIN_OUTPUT); }
+inline void spiPinInput(uint8_t pin) { spiPinConfigure(pin, SPI_PIN_INPUT); }
+inline void spiPinPeripheral(uint8_t pin) { spiPinConfigure(pin, spiPinAlternate(pin)); }
+
+#else
+
+inline void spiPinHigh(uint8_t pin) { digitalWrite(pin, HIGH); }
+inline void spiPinLow(uint8_t pin) { digitalWrite(pin, LOW); }
+inline bool spiPinRead(uint8_t pin) { return digitalRead(pin) == HIGH; }
+inline void spiPinOutput(uint8_t pin) { pinMode(pin, OUTPUT); }
+inline void spiPinInput(uint8_t pin) { pinMode(pin, INPUT); }
+// SCK and MOSI are plain outputs here; the SPI block overrides MISO.
+inline void spiPinPeripheral(uint8_t pin) { pinMode(pin, OUTPUT); }
+
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_poller.h"
+
+SPIPoller::SPIPoller()
+  : count(0), next(0)
+{
+}
+
+// Bytes a program appends to the sample, or 0xFF if it is malformed.
+static uint8_t programLength(const byte *program)
+{
+  uint16_t total = 0;
+  while (*program) {
+    program += 1 + *program;
+    total += *program++;
+  }
+  return total > 0xFE ? 0xFF : total;
+}
+
+int8_t SPIPoller::add(SPIDevice *device, const SPIPollRecipe *recipe)
+{
+  if (count == SPI_POLLER_SOURCES)
+    return -1;
+  uint8_t length = programLength(recipe->read);
+  if (length > SPI_POLLER_SAMPLE_SIZE)
+    return -1;
+  if (recipe->readyPin == SPI_POLL_STATUS &&
+      programLength(recipe->status) > SPI_POLLER_SAMPLE_SIZE)
+    return -1;
+
+  Source &source = sources[count];
+  source.device = device;
+  source.recipe = recipe;
+  source.length = length;
+  source.front = 0;
+  source.fresh = false;
+  source.samples = 0;
+  if (recipe->readyPin != SPI_POLL_STATUS)
+    spiPinInput(recipe->readyPin);
+  return count++;
+}
+
+uint8_t SPIPoller::poll()
+{
+  uint8_t taken = 0;
+  uint8_t start = next;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t index = (start + i) % count;
+    Source &source = sources[index];
+    if (!ready(source))
+      continue;
+
+    // Fill the back buffer, then flip: fetch() never sees a half
+    // written sample.
+    uint8_t back = source.front ^ 1;
+    run(source.device, source.recipe->read, source.buffer[back]);
+    source.front = back;
+    source.fresh = true;
+    source.samples++;
+    taken++;
+    next = (index + 1) % count;
+  }
+  return taken;
+}
+
+uint8_t SPIPoller::fetch(uint8_t index, void *dst)
+{
+  if (index >= count || !sources[index].fresh)
+    return 0;
+  Source &source = sources[index];
+  source.fresh = false;
+  memcpy(dst, source.buffer[source.front], source.length);
+  return source.length;
+}
+
+uint32_t SPIPoller::samples(uint8_t index) const
+{
+  return index < count ? sources[index].samples : 0;
+}
+
+bool SPIPoller::ready(Source &source)
+{
+  const SPIPollRecipe *recipe = source.recipe;
+  if (recipe->readyPin != SPI_POLL_STATUS)
+    return spiPinRead(recipe->readyPin) == (recipe->readyLevel != LOW);
+
+  byte status[SPI_POLLER_SAMPLE_SIZE];
+  uint8_t n = run(source.device, recipe->status, status);
+  return n && (status[n - 1] & recipe->readyMask) == recipe->readyValue;
+}
+
+// Runs each step of a program as one transaction and returns the
+// number of response bytes written to out.
+uint8_t SPIPoller::run(SPIDevice *device, const byte *program, byte *out)
+{
+  uint8_t written = 0;
+  while (*program) {
+    uint8_t commandLength = *program++;
+    device->select();
+    device->transfer(program, NULL, commandLength);
+    program += commandLength;
+    uint8_t responseLength = *program++;
+    device->transfer(NULL, out + written, responseLength);
+    device->deselect();
+    written += responseLength;
+  }
+  return written;
+}
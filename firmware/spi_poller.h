@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_POLLER_H_INCLUDED
+#define _SPI_POLLER_H_INCLUDED
+
+#include "spi_device.h"
+
+#ifndef SPI_POLLER_SOURCES
+#define SPI_POLLER_SOURCES 4
+#endif
+#ifndef SPI_POLLER_SAMPLE_SIZE
+#define SPI_POLLER_SAMPLE_SIZE 8
+#endif
+
+// readyPin value for sources whose ready state is a status register.
+#define SPI_POLL_STATUS 0xFF
+
+// How to tell a source has data and how to fetch it. The read and
+// status programs are lists of steps, each run in its own chip select
+// window:
+//
+//   command length, command bytes..., response length
+//
+// ending with a zero command length. Responses are appended to the
+// sample in order. For the SCP1000 in BarometricPressureSensor.ino:
+//
+//   static const byte scp1000Read[] = {
+//     1, 0x1F << 2, 1,    // DATARD8
+//     1, 0x20 << 2, 2,    // DATARD16
+//     0
+//   };
+//   static const SPIPollRecipe scp1000 = { 6, HIGH, NULL, 0, 0, scp1000Read };
+struct SPIPollRecipe {
+  uint8_t readyPin;       // or SPI_POLL_STATUS
+  uint8_t readyLevel;
+  const byte *status;     // program whose last response byte is checked
+  byte readyMask;         // ready when (status & readyMask) == readyValue
+  byte readyValue;
+  const byte *read;
+};
+
+// Services a table of sources in round-robin order: each poll() visits
+// every source once, starting after the last one read, and reads those
+// that are ready. A source that is not ready costs a pin read (or one
+// status transaction), so slow parts no longer hold up fast ones.
+// Samples land in a per-source double buffer; fetch() always sees the
+// last complete one.
+class SPIPoller {
+public:
+  SPIPoller();
+
+  // Returns the source index, or -1 if the table is full or the read
+  // program produces more than SPI_POLLER_SAMPLE_SIZE bytes.
+  int8_t add(SPIDevice *device, const SPIPollRecipe *recipe);
+
+  // One round over all sources. Returns the number of samples taken.
+  uint8_t poll();
+
+  // Copies the latest sample for a source into dst and returns its
+  // length, or 0 if nothing new arrived since the last fetch.
+  uint8_t fetch(uint8_t source, void *dst);
+  uint32_t samples(uint8_t source) const;
+
+private:
+  struct Source {
+    SPIDevice *device;
+    const SPIPollRecipe *recipe;
+    uint8_t length;
+    volatile uint8_t front;
+    volatile bool fresh;
+    uint32_t samples;
+    byte buffer[2][SPI_POLLER_SAMPLE_SIZE];
+  };
+
+  static bool ready(Source &source);
+  static uint8_t run(SPIDevice *device, const byte *program, byte *out);
+
+  Source sources[SPI_POLLER_SOURCES];
+  uint8_t count;
+  uint8_t next;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_pool.h"
+
+// Blocks never handed out yet are taken from the end of the storage, so
+// the free list needs no initialisation pass. Freed blocks hold the
+// free-list link in their first bytes.
+struct PoolList {
+  void *head;
+  uint8_t untouched;
+  SPIPoolStats stats;
+};
+
+// The link member aligns every buffer for the free-list pointer; the
+// union's size rounds the stride up to match.
+union PoolBuffer {
+  void *link;
+  byte data[SPI_POOL_BUFFER_SIZE];
+};
+
+static SPITransaction transactionStorage[SPI_POOL_TRANSACTIONS];
+static PoolBuffer bufferStorage[SPI_POOL_BUFFERS];
+static PoolList transactionList;
+static PoolList bufferList;
+
+static void *poolAlloc(PoolList &list, byte *storage, size_t stride, uint8_t count)
+{
+  uint8_t sreg = SREG;
+  noInterrupts();
+  void *block = list.head;
+  if (block)
+    list.head = *(void **)block;
+  else if (list.untouched < count)
+    block = storage + stride * list.untouched++;
+
+  if (block) {
+    if (++list.stats.inUse > list.stats.highWater)
+      list.stats.highWater = list.stats.inUse;
+  } else {
+    list.stats.failures++;
+  }
+  SREG = sreg;
+  return block;
+}
+
+static void poolFree(PoolList &list, void *block)
+{
+  if (!block)
+    return;
+  uint8_t sreg = SREG;
+  noInterrupts();
+  *(void **)block = list.head;
+  list.head = block;
+  list.stats.inUse--;
+  SREG = sreg;
+}
+
+SPITransaction *SPIPool::allocTransaction()
+{
+  return (SPITransaction *)poolAlloc(transactionList, (byte *)transactionStorage,
+                                     sizeof(SPITransaction), SPI_POOL_TRANSACTIONS);
+}
+
+void SPIPool::freeTransaction(SPITransaction *transaction)
+{
+  poolFree(transactionList, transaction);
+}
+
+byte *SPIPool::allocBuffer()
+{
+  return (byte *)poolAlloc(bufferList, (byte *)bufferStorage,
+                           sizeof(PoolBuffer), SPI_POOL_BUFFERS);
+}
+
+void SPIPool::freeBuffer(byte *buffer)
+{
+  poolFree(bufferList, buffer);
+}
+
+void SPIPool::stats(SPIPoolStats *transactions, SPIPoolStats *buffers)
+{
+  uint8_t sreg = SREG;
+  noInterrupts();
+  if (transactions)
+    *transactions = transactionList.stats;
+  if (buffers)
+    *buffers = bufferList.stats;
+  SREG = sreg;
+}
+
+// High-water marks restart from what is currently allocated.
+void SPIPool::resetStats()
+{
+  uint8_t sreg = SREG;
+  noInterrupts();
+  transactionList.stats.highWater = transactionList.stats.inUse;
+  transactionList.stats.failures = 0;
+  bufferList.stats.highWater = bufferList.stats.inUse;
+  bufferList.stats.failures = 0;
+  SREG = sreg;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_POOL_H_INCLUDED
+#define _SPI_POOL_H_INCLUDED
+
+#include "spi.h"
+
+// Pool sizes are fixed at compile time; use the high-water marks from
+// SPIPool::stats() to trim them for a given product.
+#ifndef SPI_POOL_TRANSACTIONS
+#define SPI_POOL_TRANSACTIONS 8
+#endif
+#ifndef SPI_POOL_BUFFERS
+#define SPI_POOL_BUFFERS 4
+#endif
+#ifndef SPI_POOL_BUFFER_SIZE
+#define SPI_POOL_BUFFER_SIZE 32
+#endif
+
+// A free buffer holds the free-list link.
+static_assert(SPI_POOL_BUFFER_SIZE >= sizeof(void *),
+              "SPI_POOL_BUFFER_SIZE must hold a pointer");
+
+struct SPITransaction {
+  SPITransaction *next;
+  const void *txBuf;
+  void *rxBuf;
+  size_t count;
+  SPISettings settings;
+  uint8_t csPin;
+  void (*done)(SPITransaction *transaction);
+  void *context;
+};
+
+struct SPIPoolStats {
+  uint8_t inUse;
+  uint8_t highWater;
+  uint16_t failures;
+};
+
+// Library-owned storage for transaction descriptors and bounce buffers.
+// Allocation and release are O(1) and safe from interrupt handlers: the
+// free list is only touched inside a critical section of a few cycles.
+class SPIPool {
+public:
+  static SPITransaction *allocTransaction();
+  static void freeTransaction(SPITransaction *transaction);
+  static byte *allocBuffer();
+  static void freeBuffer(byte *buffer);
+
+  static void stats(SPIPoolStats *transactions, SPIPoolStats *buffers);
+  static void resetStats();
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi.h"
+
+#if defined(__AVR__) && !defined(SPI_EMULATION)
+#include <avr/power.h>
+#endif
+
+uint8_t SPIClass::suspendedSpcr;
+uint8_t SPIClass::suspendedSpsr;
+uint8_t SPIClass::suspendedDir;
+uint8_t SPIClass::suspendedOut;
+
+// SS, SCK and MOSI share a port on every supported part, so their state
+// is saved and restored as one masked port update.
+static inline uint8_t spiPinBits()
+{
+  return digitalPinToBitMask(SS) | digitalPinToBitMask(SCK) |
+         digitalPinToBitMask(MOSI);
+}
+
+void SPIClass::suspend()
+{
+  volatile uint8_t *dir = portModeRegister(digitalPinToPort(SCK));
+  volatile uint8_t *out = portOutputRegister(digitalPinToPort(SCK));
+  uint8_t mask = spiPinBits();
+
+  uint8_t oldSREG = SREG;
+  noInterrupts();
+  suspendedSpcr = SPCR;
+  suspendedSpsr = SPSR & _BV(SPI2X);
+  suspendedDir = *dir & mask;
+  suspendedOut = *out & mask;
+
+  // Once SPE is cleared SCK is driven from PORT, so set it to the CPOL
+  // idle level first: devices must not see an edge.
+  if (suspendedSpcr & _BV(CPOL))
+    *out |= digitalPinToBitMask(SCK);
+  else
+    *out &= ~digitalPinToBitMask(SCK);
+  SPCR = suspendedSpcr & ~_BV(SPE);
+#ifdef power_spi_disable
+  power_spi_disable();
+#endif
+  SREG = oldSREG;
+}
+
+void SPIClass::resume()
+{
+  volatile uint8_t *dir = portModeRegister(digitalPinToPort(SCK));
+  volatile uint8_t *out = portOutputRegister(digitalPinToPort(SCK));
+  uint8_t mask = spiPinBits();
+
+  uint8_t oldSREG = SREG;
+  noInterrupts();
+#ifdef power_spi_enable
+  power_spi_enable();
+#endif
+  *out = (*out & ~mask) | suspendedOut;
+  *dir = (*dir & ~mask) | suspendedDir;
+  SPSR = suspendedSpsr;
+  SPCR = suspendedSpcr;
+  SREG = oldSREG;
+}
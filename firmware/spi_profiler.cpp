@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_profiler.h"
+
+static SPIDeviceProfile profiles[SPI_PROFILER_DEVICES];
+static uint32_t requestedAt[SPI_PROFILER_DEVICES];
+// Separate from requestedAt: micros() may well be 0 at a request.
+static bool requestPending[SPI_PROFILER_DEVICES];
+static uint32_t selectedAt[SPI_PROFILER_DEVICES];
+static SPIHistogram idleHistogram;
+static uint32_t lastDeselect;
+static bool seenTransaction;
+
+static uint32_t windowBusy[SPI_PROFILER_WINDOWS];
+static uint32_t windowStart;
+static uint8_t windowIndex;
+
+void SPIHistogram::add(uint32_t value)
+{
+  uint8_t index = 0;
+  while (value && index < SPI_PROFILER_BUCKETS - 1) {
+    value >>= 1;
+    index++;
+  }
+  if (bucket[index] != 0xFFFF)
+    bucket[index]++;
+}
+
+void SPIProfiler::requested(uint8_t device)
+{
+  if (device >= SPI_PROFILER_DEVICES)
+    return;
+  requestedAt[device] = micros();
+  requestPending[device] = true;
+}
+
+void SPIProfiler::selected(uint8_t device)
+{
+  if (device >= SPI_PROFILER_DEVICES)
+    return;
+  uint32_t now = micros();
+  if (requestPending[device]) {
+    profiles[device].wait.add(now - requestedAt[device]);
+    requestPending[device] = false;
+  }
+  selectedAt[device] = now;
+  if (seenTransaction)
+    idleHistogram.add(now - lastDeselect);
+}
+
+void SPIProfiler::deselected(uint8_t device, uint16_t bytes)
+{
+  if (device >= SPI_PROFILER_DEVICES)
+    return;
+  uint32_t now = micros();
+  uint32_t held = now - selectedAt[device];
+  profiles[device].hold.add(held);
+  profiles[device].bytes.add(bytes);
+  lastDeselect = now;
+  seenTransaction = true;
+  account(now, held);
+}
+
+// Adds busy time to the current window, first retiring any windows that
+// ended since the last call.
+void SPIProfiler::account(uint32_t now, uint32_t busy)
+{
+  uint8_t steps = 0;
+  while (now - windowStart >= SPI_PROFILER_WINDOW_US && steps < SPI_PROFILER_WINDOWS) {
+    windowStart += SPI_PROFILER_WINDOW_US;
+    windowIndex = (windowIndex + 1) % SPI_PROFILER_WINDOWS;
+    windowBusy[windowIndex] = 0;
+    steps++;
+  }
+  if (steps == SPI_PROFILER_WINDOWS)
+    windowStart = now;
+  windowBusy[windowIndex] += busy;
+}
+
+const SPIDeviceProfile &SPIProfiler::device(uint8_t device)
+{
+  return profiles[device < SPI_PROFILER_DEVICES ? device : 0];
+}
+
+const SPIHistogram &SPIProfiler::idleGaps()
+{
+  return idleHistogram;
+}
+
+uint8_t SPIProfiler::utilization()
+{
+  uint32_t now = micros();
+  account(now, 0);
+
+  uint32_t busy = 0;
+  for (uint8_t i = 0; i < SPI_PROFILER_WINDOWS; i++)
+    busy += windowBusy[i];
+  uint32_t span = (SPI_PROFILER_WINDOWS - 1) * SPI_PROFILER_WINDOW_US +
+                  (now - windowStart);
+  if (busy >= span)
+    return 100;
+  // At most 8 windows of 125ms in us: busy * 100 fits in 32 bits.
+  return busy * 100 / span;
+}
+
+static byte *putHistogram(byte *out, const SPIHistogram &histogram)
+{
+  for (uint8_t i = 0; i < SPI_PROFILER_BUCKETS; i++) {
+    *out++ = histogram.bucket[i];
+    *out++ = histogram.bucket[i] >> 8;
+  }
+  return out;
+}
+
+size_t SPIProfiler::serialize(byte *buf, size_t len)
+{
+  const size_t histogramSize = 2 * SPI_PROFILER_BUCKETS;
+  size_t needed = 3 + (3 * SPI_PROFILER_DEVICES + 1) * histogramSize + 1;
+  if (len < needed)
+    return 0;
+
+  byte *out = buf;
+  *out++ = SPI_PROFILER_FORMAT;
+  *out++ = SPI_PROFILER_DEVICES;
+  *out++ = SPI_PROFILER_BUCKETS;
+  for (uint8_t i = 0; i < SPI_PROFILER_DEVICES; i++) {
+    out = putHistogram(out, profiles[i].wait);
+    out = putHistogram(out, profiles[i].hold);
+    out = putHistogram(out, profiles[i].bytes);
+  }
+  out = putHistogram(out, idleHistogram);
+  *out++ = utilization();
+  return out - buf;
+}
+
+void SPIProfiler::reset()
+{
+  memset(profiles, 0, sizeof(profiles));
+  memset(requestPending, 0, sizeof(requestPending));
+  memset(&idleHistogram, 0, sizeof(idleHistogram));
+  memset(windowBusy, 0, sizeof(windowBusy));
+  windowStart = micros();
+  windowIndex = 0;
+  seenTransaction = false;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_PROFILER_H_INCLUDED
+#define _SPI_PROFILER_H_INCLUDED
+
+#include "spi.h"
+
+#ifndef SPI_PROFILER_DEVICES
+#define SPI_PROFILER_DEVICES 4
+#endif
+// Bucket n counts values in [2^(n-1), 2^n); the last one is open ended.
+#ifndef SPI_PROFILER_BUCKETS
+#define SPI_PROFILER_BUCKETS 12
+#endif
+#ifndef SPI_PROFILER_WINDOWS
+#define SPI_PROFILER_WINDOWS 8
+#endif
+#ifndef SPI_PROFILER_WINDOW_US
+#define SPI_PROFILER_WINDOW_US 125000UL
+#endif
+
+#define SPI_PROFILER_FORMAT 2
+
+struct SPIHistogram {
+  uint16_t bucket[SPI_PROFILER_BUCKETS];
+
+  void add(uint32_t value);
+};
+
+struct SPIDeviceProfile {
+  SPIHistogram wait;   // requested() to chip select asserted, us
+  SPIHistogram hold;   // chip select asserted, us
+  SPIHistogram bytes;  // bytes per transaction
+};
+
+// Opt-in timing profiler. Drivers (or SPIDevice when built with
+// SPI_PROFILING) report selected/deselected per device; the transfer
+// loops are not instrumented. Drivers that queue work call requested()
+// when the work is queued, and only those transactions feed the wait
+// histogram. Times come from micros(), 4us steps on a 16 MHz AVR.
+//
+// There is no histogram of idle gaps between bytes: micros() is too
+// coarse for it, and the AVR has no free-running cycle counter to spare
+// (Timer1 belongs to PWM and Servo). idleGaps() is the idle time between
+// transactions. On the host, SPIEmulator::maxByteGap() measures the
+// gaps between bytes in cycles.
+class SPIProfiler {
+public:
+  static void requested(uint8_t device);
+  static void selected(uint8_t device);
+  static void deselected(uint8_t device, uint16_t bytes);
+
+  static const SPIDeviceProfile &device(uint8_t device);
+  static const SPIHistogram &idleGaps();  // bus idle between transactions, us
+  static uint8_t utilization();           // percent, over the sliding windows
+
+  // Compact little-endian dump for offline analysis: format byte, device
+  // count, bucket count, then every histogram and the utilization.
+  // Returns the number of bytes written, or 0 if buf is too small.
+  static size_t serialize(byte *buf, size_t len);
+  static void reset();
+
+private:
+  static void account(uint32_t now, uint32_t busy);
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_slave.h"
+
+#define RING (SPI_SLAVE_FRAMES + 1)
+
+SPISlaveFrame SPISlave::pool[SPI_SLAVE_FRAMES];
+SPISlaveFrame *volatile SPISlave::current;
+uint8_t SPISlave::position;
+bool SPISlave::selectLow;
+SPISlaveFrame *SPISlave::readyRing[RING];
+volatile uint8_t SPISlave::readyHead, SPISlave::readyTail;
+SPISlaveFrame *SPISlave::freeRing[RING];
+volatile uint8_t SPISlave::freeHead, SPISlave::freeTail;
+const byte *SPISlave::reply;
+uint8_t SPISlave::replyLength;
+byte SPISlave::replyFill;
+const byte *volatile SPISlave::pendingReply;
+uint8_t SPISlave::pendingLength;
+byte SPISlave::pendingFill;
+volatile uint16_t SPISlave::dropped;
+
+void SPISlave::begin()
+{
+  // One frame is always being filled; the rest start out free.
+  current = &pool[0];
+  current->length = 0;
+  current->truncated = false;
+  position = 0;
+  readyHead = readyTail = 0;
+  freeHead = 0;
+  freeTail = SPI_SLAVE_FRAMES - 1;
+  for (uint8_t i = 1; i < SPI_SLAVE_FRAMES; i++)
+    freeRing[i - 1] = &pool[i];
+  dropped = 0;
+
+  SPIClass::beginSlave();
+  selectLow = !spiPinRead(SS);
+  takeReply();
+  SPDR = replyLength ? reply[0] : replyFill;
+  SPIClass::attachInterrupt(onByte);
+  SPIClass::enableSelectInterrupt(true);
+}
+
+void SPISlave::end()
+{
+  SPIClass::enableSelectInterrupt(false);
+  SPIClass::detachInterrupt();
+  SPI.end();
+}
+
+SPISlaveFrame *SPISlave::receive()
+{
+  if (readyHead == readyTail)
+    return NULL;
+  SPI_MEMORY_BARRIER();
+  SPISlaveFrame *frame = readyRing[readyHead];
+  readyHead = (readyHead + 1) % RING;
+  return frame;
+}
+
+void SPISlave::release(SPISlaveFrame *frame)
+{
+  freeRing[freeTail] = frame;
+  SPI_MEMORY_BARRIER();
+  freeTail = (freeTail + 1) % RING;
+}
+
+void SPISlave::setReply(const void *data, uint8_t length, byte fill)
+{
+  // Picked up at the next frame boundary so a reply is never mixed
+  // with the one before it.
+  uint8_t oldSREG = SREG;
+  noInterrupts();
+  pendingLength = length;
+  pendingFill = fill;
+  pendingReply = length ? (const byte *)data : &pendingFill;
+  SREG = oldSREG;
+}
+
+void SPISlave::onByte()
+{
+  byte in = SPDR;
+  uint8_t at = position;
+  // Load the next reply byte first; the master may already be clocking.
+  uint8_t next = at + 1;
+  SPDR = next < replyLength ? reply[next] : replyFill;
+  if (next != 0)
+    position = next;
+
+  SPISlaveFrame *frame = current;
+  if (at < SPI_SLAVE_FRAME_SIZE)
+    frame->data[at] = in;
+  else
+    frame->truncated = true;
+}
+
+// Adopts a reply set with setReply(), at a frame boundary or before the
+// first frame.
+void SPISlave::takeReply()
+{
+  if (pendingReply) {
+    reply = pendingReply;
+    replyLength = pendingLength;
+    replyFill = pendingFill;
+    pendingReply = NULL;
+  }
+}
+
+void SPISlave::selectChanged()
+{
+  bool wasLow = selectLow;
+  selectLow = !spiPinRead(SS);
+  if (selectLow)
+    return;
+
+  // The pin change vector outranks the SPI one, so the last byte of the
+  // frame may still be waiting for onByte(). Take it now or it would
+  // open the next frame.
+  if (SPSR & _BV(SPIF))
+    onByte();
+  // High before and after with nothing received: another pin of the
+  // group changed. With bytes, the whole select fell between two runs.
+  if (!wasLow && position == 0)
+    return;
+
+  // SS went high: the frame is complete. Hand it over and take a free
+  // one, or keep filling the same one if the sketch holds them all.
+  SPISlaveFrame *frame = current;
+  frame->length = position < SPI_SLAVE_FRAME_SIZE ? position : SPI_SLAVE_FRAME_SIZE;
+  position = 0;
+  if (frame->length) {
+    if (freeHead != freeTail) {
+      readyRing[readyTail] = frame;
+      SPI_MEMORY_BARRIER();
+      readyTail = (readyTail + 1) % RING;
+      SPI_MEMORY_BARRIER();
+      frame = freeRing[freeHead];
+      freeHead = (freeHead + 1) % RING;
+      current = frame;
+    } else {
+      dropped++;
+    }
+  }
+  frame->length = 0;
+  frame->truncated = false;
+
+  takeReply();
+  SPDR = replyLength ? reply[0] : replyFill;
+}
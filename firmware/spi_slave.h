@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef _SPI_SLAVE_H_INCLUDED
+#define _SPI_SLAVE_H_INCLUDED
+
+#include "spi.h"
+
+#ifndef SPI_SLAVE_FRAMES
+#define SPI_SLAVE_FRAMES 4
+#endif
+#ifndef SPI_SLAVE_FRAME_SIZE
+#define SPI_SLAVE_FRAME_SIZE 32
+#endif
+
+struct SPISlaveFrame {
+  uint8_t length;
+  bool truncated;  // the master clocked more than SPI_SLAVE_FRAME_SIZE bytes
+  byte data[SPI_SLAVE_FRAME_SIZE];
+};
+
+// Slave-mode receiver that frames on the master's SS: bytes are stored
+// straight into a pooled frame by the SPI interrupt, and the rising edge
+// of SS (seen through the pin change interrupt) hands the frame over.
+// Frames move between the interrupt and the sketch by pointer only.
+//
+//   SPI_INTERRUPT_VECTOR
+//   SPI_SLAVE_SELECT_VECTOR
+//   ...
+//   SPISlave::begin();
+//   ...
+//   SPISlaveFrame *frame = SPISlave::receive();
+//   if (frame) {
+//     handle(frame->data, frame->length);
+//     SPISlave::release(frame);
+//   }
+//
+// The AVR shifter has a single transmit buffer, so every reply byte
+// after the first is loaded from the SPI interrupt: the master must
+// leave the handler time between bytes.
+//
+// A sketch that already handles PCINT0 (or uses SoftwareSerial on port
+// B) leaves out SPI_SLAVE_SELECT_VECTOR and calls selectChanged() from
+// its own handler instead.
+class SPISlave {
+public:
+  static void begin();
+  static void end();
+
+  // Next complete frame, or NULL. The frame belongs to the caller until
+  // it is given back with release().
+  static SPISlaveFrame *receive();
+  static void release(SPISlaveFrame *frame);
+
+  // Sends data from the next frame on; bytes past length are sent as
+  // fill. The buffer is used in place: it may be reused once
+  // replyPending() returns false after a later setReply().
+  static void setReply(const void *data, uint8_t length, byte fill = 0x00);
+  static bool replyPending() { return pendingReply != NULL; }
+
+  // Frames dropped because the application held every buffer.
+  static uint16_t overruns() { return dropped; }
+
+  // Called from the pin change vector on an SS edge; any pin change
+  // may call it, it checks SS itself. A deselect and reselect that both
+  // happen before it runs cannot be told from another pin's change and
+  // keep the frame open; a select and deselect that both happen before
+  // it runs still close the frame.
+  static void selectChanged();
+
+private:
+  static void onByte();
+  static void takeReply();
+
+  static SPISlaveFrame pool[SPI_SLAVE_FRAMES];
+  static SPISlaveFrame *volatile current;
+  static uint8_t position;
+  static bool selectLow;  // SS level seen by the last selectChanged()
+
+  // Two single-producer rings of frame pointers: completed frames from
+  // the interrupt to the sketch, and released ones back.
+  static SPISlaveFrame *readyRing[SPI_SLAVE_FRAMES + 1];
+  static volatile uint8_t readyHead, readyTail;
+  static SPISlaveFrame *freeRing[SPI_SLAVE_FRAMES + 1];
+  static volatile uint8_t freeHead, freeTail;
+
+  static const byte *reply;
+  static uint8_t replyLength;
+  static byte replyFill;
+  static const byte *volatile pendingReply;
+  static uint8_t pendingLength;
+  static byte pendingFill;
+  static volatile uint16_t dropped;
+};
+
+#ifdef PCINT0_vect
+#define SPI_SLAVE_SELECT_VECTOR ISR(PCINT0_vect) { SPISlave::selectChanged(); }
+#else
+#define SPI_SLAVE_SELECT_VECTOR
+#endif
+
+#endif
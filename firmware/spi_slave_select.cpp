@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi.h"
+
+// SS is on port B on the supported parts, which is pin change group 0.
+// The vector itself is left to the sketch (SPI_SLAVE_SELECT_VECTOR or
+// SPI_LINK_SELECT_VECTOR) so it does not clash with SoftwareSerial or a
+// handler of the sketch's own.
+
+void SPIClass::enableSelectInterrupt(bool enable)
+{
+#if defined(digitalPinToPCICR) && !defined(SPI_EMULATION)
+  if (enable) {
+    *digitalPinToPCMSK(SS) |= _BV(digitalPinToPCMSKbit(SS));
+    PCIFR = _BV(digitalPinToPCICRbit(SS));
+    *digitalPinToPCICR(SS) |= _BV(digitalPinToPCICRbit(SS));
+  } else {
+    *digitalPinToPCMSK(SS) &= ~_BV(digitalPinToPCMSKbit(SS));
+  }
+#else
+  // No pin change interrupt: the sketch (or the emulation) must call
+  // the receiver's selectChanged() on SS edges itself.
+  (void)enable;
+#endif
+}
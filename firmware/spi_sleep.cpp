@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi_async.h"
+
+#if defined(__AVR__) && !defined(SPI_EMULATION)
+#include <avr/sleep.h>
+#endif
+
+// Runs the transfer from the SPI interrupt and sleeps between bytes.
+// The busy check and the sleep instruction must not be separated by an
+// interrupt, or the last completion could be missed and the CPU would
+// sleep with nothing left to wake it.
+static bool sleepingTransfer(const void *txBuf, void *rxBuf, size_t count, byte fill)
+{
+#if defined(__AVR__) && !defined(SPI_EMULATION)
+  // With interrupts off (e.g. a transaction in global masking mode)
+  // nothing would wake us up.
+  if (!(SREG & _BV(SREG_I)))
+    return false;
+#endif
+  if (!SPIAsync::start(txBuf, rxBuf, count, fill))
+    return false;
+
+  while (SPIAsync::busy()) {
+#if defined(SPI_EMULATION)
+    SPIEmulator::advance(1);
+#elif defined(__AVR__)
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    noInterrupts();
+    if (SPIAsync::busy()) {
+      sleep_enable();
+      interrupts();  // SEI: the next instruction runs before any interrupt
+      sleep_cpu();
+      sleep_disable();
+    } else {
+      interrupts();
+    }
+#elif defined(__arm__)
+    // WFI wakes on a pending interrupt even while PRIMASK masks it.
+    __disable_irq();
+    if (SPIAsync::busy())
+      __WFI();
+    __enable_irq();
+#endif
+  }
+  return true;
+}
+
+void SPIClass::enableIdleSleep()
+{
+  idleTransfer = sleepingTransfer;
+}
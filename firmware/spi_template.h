@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Command headers built at compile time. A register or flash command
+// that only ever takes one form is written once as a template argument
+// list; the bytes are folded into the code as constants, so a register
+// access no longer shifts and masks on every call, and only the payload
+// is passed at run time.
+//
+//   // SCP1000: register << 2, bit 1 set for writes
+//   typedef SPIFrame<spiCommand(0x1F, 2, 0x00)> ReadPressureHigh;
+//   typedef SPIFrame<spiCommand(0x03, 2, 0x02)> WriteOperation;
+//   // 25-series flash, READ at a fixed address
+//   typedef SPIFrame<0x03, spiByte(0x1000, 2), spiByte(0x1000, 1),
+//                    spiByte(0x1000, 0)> ReadFont;
+//
+//   digitalWrite(chipSelectPin, LOW);
+//   WriteOperation::transfer(&mode, NULL, 1);
+//   digitalWrite(chipSelectPin, HIGH);
+
+#ifndef _SPI_TEMPLATE_H_INCLUDED
+#define _SPI_TEMPLATE_H_INCLUDED
+
+#include "spi.h"
+
+// Register number moved into place and combined with read/write flags.
+constexpr byte spiCommand(byte reg, uint8_t shift, byte flags)
+{
+  return (byte)((reg << shift) | flags);
+}
+
+// Byte n of a multi-byte address or argument, 0 being the least
+// significant.
+constexpr byte spiByte(uint32_t value, uint8_t n)
+{
+  return (byte)(value >> (8 * n));
+}
+
+template <byte... Header>
+struct SPIFrame {
+  static const uint8_t length = sizeof...(Header);
+  // The same header as a table in flash, for callers that assemble
+  // frames in RAM (see load()).
+  static const byte bytes[sizeof...(Header)] PROGMEM;
+
+  // Sends the header, then count payload bytes. Only the payload is
+  // received into rxBuf; either buffer may be NULL as with
+  // SPIClass::transfer().
+  inline static void transfer(const void *txBuf, void *rxBuf, size_t count,
+                              byte fill = 0x00)
+  {
+    sendHeader();
+    SPI.transfer(txBuf, rxBuf, count, fill);
+  }
+
+  // Single-byte forms for the common register read and write.
+  inline static byte read(byte fill = 0x00)
+  {
+    sendHeader();
+    return SPI.transfer(fill);
+  }
+
+  inline static void write(byte value)
+  {
+    sendHeader();
+    SPI.transfer(value);
+  }
+
+  // Copies the header to dst and returns the position right after it,
+  // where the caller patches in the payload.
+  inline static byte *load(byte *dst)
+  {
+    for (uint8_t i = 0; i < length; i++)
+      dst[i] = pgm_read_byte(&bytes[i]);
+    return dst + length;
+  }
+
+private:
+  // Expands to one SPDR store of a constant per header byte. Braced
+  // initializers are evaluated in order, so the bytes go out as listed.
+  inline static void sendHeader()
+  {
+    byte sent[] = { SPI.transfer(Header)... };
+    (void)sent;
+  }
+};
+
+template <byte... Header>
+const byte SPIFrame<Header...>::bytes[sizeof...(Header)] PROGMEM = { Header... };
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "spi.h"
+
+// CPU cycles between SPDR writes. A byte takes 16 cycles at DIV2 and
+// 32 at DIV4; writing any earlier sets WCOL and drops the byte, so the
+// schedule keeps two cycles of margin. An interrupt between writes only
+// makes a gap longer, which is harmless.
+#define SPI_TIMED_PERIOD_DIV2 18
+#define SPI_TIMED_PERIOD_DIV4 34
+
+#if defined(__AVR__) && !defined(SPI_EMULATION)
+
+// Unrolled twice so the loop overhead is paid every other byte. Cycles
+// from the start of one "out" to the start of the next:
+//
+//   first to second of a pair   out 1 + n1 nops + ld 2                  = n1 + 3
+//   second to next pair         out 1 + n2 nops + sbiw 2 + brne 2 + ld 2 = n2 + 7
+//   last pair to the tail byte  out 1 + n2 nops + sbiw 2 + brne 1 + in 1 + ld 2
+//
+// An odd number of loop bytes enters at the second half of a pair. SPSR
+// is sampled just before the last write so a collision in the loop is
+// still visible after that write clears the flags.
+#define SPI_TIMED_SEND(period)                                            \
+  __asm__ __volatile__(                                                   \
+    "sbrc %[odd], 0\n\t"                                                  \
+    "rjmp 2f\n"                                                           \
+    "1:\n\t"                                                              \
+    "ld __tmp_reg__, %a[ptr]+\n\t"                                        \
+    "out %[spdr], __tmp_reg__\n\t"                                        \
+    ".rept %[n1]\n\tnop\n\t.endr\n"                                       \
+    "2:\n\t"                                                              \
+    "ld __tmp_reg__, %a[ptr]+\n\t"                                        \
+    "out %[spdr], __tmp_reg__\n\t"                                        \
+    ".rept %[n2]\n\tnop\n\t.endr\n\t"                                     \
+    "sbiw %[pairs], 1\n\t"                                                \
+    "brne 1b\n\t"                                                         \
+    "in %[status], %[spsr]\n\t"                                           \
+    "ld __tmp_reg__, %a[ptr]+\n\t"                                        \
+    "out %[spdr], __tmp_reg__\n\t"                                        \
+    : [ptr] "+e" (ptr), [pairs] "+w" (pairs), [status] "=&r" (status)     \
+    : [odd] "r" (odd),                                                    \
+      [spdr] "I" (_SFR_IO_ADDR(SPDR)), [spsr] "I" (_SFR_IO_ADDR(SPSR)),   \
+      [n1] "i" ((period) - 3), [n2] "i" ((period) - 7)                    \
+    : "memory")
+
+static uint8_t timedSend(const byte *ptr, size_t count, uint8_t period)
+{
+  size_t loopBytes = count - 1;
+  size_t pairs = (loopBytes + 1) / 2;
+  uint8_t odd = loopBytes & 1;
+  uint8_t status;
+
+  if (period == SPI_TIMED_PERIOD_DIV2)
+    SPI_TIMED_SEND(SPI_TIMED_PERIOD_DIV2);
+  else
+    SPI_TIMED_SEND(SPI_TIMED_PERIOD_DIV4);
+  return status;
+}
+
+#elif defined(SPI_EMULATION)
+
+// The asm above, one instruction at a time against the emulated
+// shifter: each advances the clock by its AVR cycle count, so the SPDR
+// writes land where they do on the part and the WCOL model checks the
+// nop counts, not a schedule of its own.
+static uint8_t timedSend(const byte *ptr, size_t count, uint8_t period)
+{
+  size_t loopBytes = count - 1;
+  size_t pairs = (loopBytes + 1) / 2;
+  bool odd = loopBytes & 1;
+  uint8_t status;
+
+  // "out" and "in" take one cycle each.
+  SPIEmuCosts saved = SPIEmulator::costs;
+  SPIEmulator::costs.registerAccess = 1;
+  SPIEmulator::costs.statusPoll = 1;
+
+  SPIEmulator::advance(odd ? 3 : 2);      // sbrc, rjmp 2f / sbrc skipping
+  for (;;) {
+    if (!odd) {
+      SPIEmulator::advance(2);            // 1: ld
+      SPDR = *ptr++;                      // out
+      SPIEmulator::advance(period - 3);   // nops
+    }
+    odd = false;
+    SPIEmulator::advance(2);              // 2: ld
+    SPDR = *ptr++;                        // out
+    SPIEmulator::advance(period - 7 + 2); // nops, sbiw
+    if (--pairs == 0)
+      break;
+    SPIEmulator::advance(2);              // brne taken
+  }
+  SPIEmulator::advance(1);                // brne not taken
+  status = SPSR;                          // in
+  SPIEmulator::advance(2);                // ld
+  SPDR = *ptr;                            // out
+
+  SPIEmulator::costs = saved;
+  return status;
+}
+
+#endif
+
+uint8_t SPIClass::send(const void *buf, size_t count)
+{
+  if (!(SPCR & _BV(SPE)))
+    return SPI_ERR_DISABLED;
+  if (count == 0)
+    return SPI_OK;
+
+  uint8_t period = 0;
+#if defined(__AVR__) || defined(SPI_EMULATION)
+  uint8_t divider = ((SPSR & SPI_2XCLOCK_MASK) << 2) | (SPCR & SPI_CLOCK_MASK);
+  if (divider == SPI_CLOCK_DIV2)
+    period = SPI_TIMED_PERIOD_DIV2;
+  else if (divider == SPI_CLOCK_DIV4)
+    period = SPI_TIMED_PERIOD_DIV4;
+#endif
+  if (!period || count < 2) {
+    transfer(buf, NULL, count);
+    return SPI_OK;
+  }
+
+#if defined(__AVR__) || defined(SPI_EMULATION)
+  // Clear flags left over from earlier transfers first.
+  (void)SPSR;
+  (void)SPDR;
+  uint8_t status = timedSend((const byte *)buf, count, period);
+  while (!(SPSR & _BV(SPIF)))
+    ;
+  status |= SPSR;
+  (void)SPDR;
+  return (status & _BV(WCOL)) ? SPI_ERR_COLLISION : SPI_OK;
+#else
+  return SPI_OK;
+#endif
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Stands in for the header the examples include, plus the parts of the
+// Arduino core they use besides SPI, so the sketches compile unchanged
+// against the emulation. Serial output is kept in Serial.output.
+
+#ifndef _SPI_TEST_SKETCH_H_INCLUDED
+#define _SPI_TEST_SKETCH_H_INCLUDED
+
+#include "spi.h"
+
+#include <string>
+
+#define BIN 2
+#define DEC 10
+
+class String {
+public:
+  String(long value) : text(std::to_string(value)) {}
+  String(const char *value) : text(value) {}
+  std::string text;
+};
+
+inline String operator+(const char *left, const String &right)
+{
+  return String((left + right.text).c_str());
+}
+
+class SketchSerial {
+public:
+  void begin(unsigned long) {}
+  void print(const char *text) { output += text; }
+  void print(const String &text) { output += text.text; }
+  void print(double value) { output += std::to_string(value); }
+  void print(long value, int base = DEC);
+  template <typename T> void println(T value) { print(value); output += "\n"; }
+  template <typename T> void println(T value, int base) { print((long)value, base); output += "\n"; }
+
+  std::string output;
+};
+
+inline void SketchSerial::print(long value, int base)
+{
+  if (base != BIN) {
+    output += std::to_string(value);
+    return;
+  }
+  std::string bits;
+  unsigned long v = value;
+  do {
+    bits.insert(bits.begin(), '0' + (v & 1));
+    v >>= 1;
+  } while (v);
+  output += bits;
+}
+
+static SketchSerial Serial;
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Minimal checks for the host tests: each test program counts failed
+// CHECKs and returns nonzero from main() if there were any. Also the
+// bus setup and timing checks the tests share.
+
+#ifndef _SPI_TEST_H_INCLUDED
+#define _SPI_TEST_H_INCLUDED
+
+#include "spi.h"
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(cond)                                                      \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);    \
+      testFailures++;                                                    \
+    }                                                                    \
+  } while (0)
+
+#define CHECK_EQUAL(expected, actual)                                    \
+  do {                                                                   \
+    unsigned long _e = (expected), _a = (actual);                        \
+    if (_e != _a) {                                                      \
+      printf("%s:%d: %s is %lu, expected %lu\n", __FILE__, __LINE__,     \
+             #actual, _a, _e);                                           \
+      testFailures++;                                                    \
+    }                                                                    \
+  } while (0)
+
+#define TEST_RESULT()                                                    \
+  (printf("%s: %s\n", __FILE__, testFailures ? "FAILED" : "ok"),         \
+   testFailures ? 1 : 0)
+
+// A fresh emulated bus with only device on it, selected by csPin.
+static inline void resetBus(uint8_t csPin, SPIEmuDevice *device)
+{
+  SPIEmulator::reset();
+  SPIEmulator::attach(csPin, device);
+}
+
+// What a driver built on SPI.transfer(byte) should show in the trace:
+// nothing but the SPDR read and store between bytes, and CS leading and
+// trailing SCK by at least two cycles (125 ns at 16 MHz).
+#define CHECK_POLLED_TIMING()                                            \
+  do {                                                                   \
+    CHECK(SPIEmulator::maxByteGap() <= 2 * SPIEmulator::costs.registerAccess); \
+    CHECK(SPIEmulator::minSetup() >= 2);                                 \
+    CHECK(SPIEmulator::minHold() >= 2);                                  \
+  } while (0)
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Interrupt-driven transfers and the task scheduler: one byte per
+// completion interrupt, tasks taking the bus in turn, and the polled
+// path when usingInterrupt() has to mask interrupts globally.
+
+#include "spi_async.h"
+#include "test.h"
+
+#define CS_A 7
+#define CS_B 8
+
+// Keeps what it was sent and answers with the complement.
+class Recorder : public SPIEmuDevice {
+public:
+  Recorder() : count(0) {}
+  virtual byte exchange(byte mosi) { log[count++] = mosi; return ~mosi; }
+  byte log[16];
+  uint8_t count;
+};
+
+static void setUp(Recorder &a, Recorder &b)
+{
+  resetBus(CS_A, &a);
+  SPIEmulator::attach(CS_B, &b);
+  SPI.begin();
+  SPI.setClockDivider(SPI_CLOCK_DIV16);
+}
+
+// The CPU gets control back between bytes, and each completion
+// interrupt takes exactly one byte in and sends the next.
+static void checkByteByByte()
+{
+  Recorder a, b;
+  setUp(a, b);
+  byte out[4] = { 0x10, 0x20, 0x30, 0x40 }, in[4] = { 0 };
+
+  digitalWrite(CS_A, LOW);
+  CHECK(SPIAsync::start(out, in, sizeof(out)));
+  CHECK(SPIAsync::busy());
+  CHECK(!SPIAsync::start(out, in, sizeof(out)));
+
+  uint8_t seen = 0;
+  uint32_t steps = 0;
+  bool oneAtATime = true;
+  while (SPIAsync::busy() && steps < 10000) {
+    SPIEmulator::advance(1);
+    steps++;
+    if (a.count != seen) {
+      oneAtATime = oneAtATime && a.count == seen + 1;
+      seen = a.count;
+    }
+  }
+  digitalWrite(CS_A, HIGH);
+  CHECK(oneAtATime);
+  CHECK_EQUAL(4, a.count);
+  // 128 cycles a byte at DIV16, all of them the caller's.
+  CHECK(steps >= 4 * 128);
+  CHECK_EQUAL(0x40, a.log[3]);
+  CHECK_EQUAL((byte)~0x10, in[0]);
+  CHECK_EQUAL((byte)~0x40, in[3]);
+  CHECK(!((uint8_t)SPCR & _BV(SPIE)));
+}
+
+struct Job {
+  uint8_t cs;
+  byte cmd[3];
+  byte reply[3];
+  uint8_t *order;
+  uint8_t finished;
+};
+
+static uint8_t runJob(SPITask *t)
+{
+  Job *job = (Job *)t->context;
+  SPI_TASK_BEGIN(t);
+  SPI_AWAIT_TRANSACTION(t);
+  digitalWrite(job->cs, LOW);
+  SPI_AWAIT_TRANSFER(t, job->cmd, job->reply, sizeof(job->cmd));
+  digitalWrite(job->cs, HIGH);
+  SPI.endTransaction();
+  job->finished = ++*job->order;
+  SPI_TASK_END(t);
+}
+
+// Two tasks want the bus at once: the first to ask keeps it until its
+// transaction ends, and the second runs after it without interleaving.
+static void checkJobOrder()
+{
+  Recorder a, b;
+  setUp(a, b);
+  uint8_t order = 0;
+  Job jobA = { CS_A, { 1, 2, 3 }, { 0 }, &order, 0 };
+  Job jobB = { CS_B, { 4, 5, 6 }, { 0 }, &order, 0 };
+  SPITask taskA, taskB;
+  CHECK(SPIScheduler::add(&taskA, runJob, &jobA));
+  CHECK(SPIScheduler::add(&taskB, runJob, &jobB));
+
+  uint32_t rounds = 0, idle = 0;
+  while ((!jobA.finished || !jobB.finished) && rounds < 10000) {
+    if (!SPIScheduler::run())
+      idle++;
+    SPIEmulator::advance(16);
+    rounds++;
+  }
+  CHECK_EQUAL(1, jobA.finished);
+  CHECK_EQUAL(2, jobB.finished);
+  // With A blocked on its transfer and B waiting for the bus, B still
+  // polls; only once B is blocked too is there nothing to run.
+  CHECK(idle > 0);
+  CHECK_EQUAL(3, a.count);
+  CHECK_EQUAL(3, b.count);
+  CHECK_EQUAL(6, b.log[2]);
+  CHECK_EQUAL((byte)~3, jobA.reply[2]);
+  CHECK_EQUAL((byte)~4, jobB.reply[0]);
+  CHECK(!SPIScheduler::runnable());
+  CHECK(!SPI.inTransaction());
+}
+
+// A handler that can't be masked on its own makes transactions disable
+// interrupts altogether. No completion interrupt can run then, so the
+// transfer is polled inside start() and the task never blocks.
+static void checkGlobalMaskFallback()
+{
+  Recorder a, b;
+  setUp(a, b);
+  SPI.usingInterrupt(255);
+
+  CHECK(SREG & _BV(SREG_I));
+  SPI.beginTransaction();
+  CHECK(!(SREG & _BV(SREG_I)));
+  SPITask task;
+  task.blocked = 0;
+  byte out[3] = { 7, 8, 9 }, in[3] = { 0 };
+  digitalWrite(CS_A, LOW);
+  CHECK(SPIAsync::start(out, in, sizeof(out), 0x00, &task));
+  CHECK(!SPIAsync::busy());
+  CHECK_EQUAL(0, task.blocked);
+  CHECK_EQUAL(3, a.count);
+  CHECK_EQUAL((byte)~9, in[2]);
+  digitalWrite(CS_A, HIGH);
+  SPI.endTransaction();
+  CHECK(SREG & _BV(SREG_I));
+
+  // The same through a task: it runs to the end in one pass.
+  uint8_t order = 0;
+  Job job = { CS_B, { 1, 2, 3 }, { 0 }, &order, 0 };
+  CHECK(SPIScheduler::add(&task, runJob, &job));
+  CHECK(SPIScheduler::run());
+  CHECK_EQUAL(1, job.finished);
+  CHECK_EQUAL(3, b.count);
+  CHECK(!SPIScheduler::runnable());
+}
+
+int main()
+{
+  checkByteByByte();
+  checkJobOrder();
+  // Last: usingInterrupt() can't be undone.
+  checkGlobalMaskFallback();
+  return TEST_RESULT();
+}
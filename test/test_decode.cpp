@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// The RLE and LZ decoders against assets packed by reference encoders
+// for the formats described in spi_decode.h, both byte by byte and
+// streamed onto the bus.
+
+#include "spi_decode.h"
+#include "test.h"
+
+#include <vector>
+
+#define CS_PIN 9
+
+typedef std::vector<byte> Bytes;
+
+class Recorder : public SPIEmuDevice {
+public:
+  virtual byte exchange(byte mosi) { bytes.push_back(mosi); return 0x00; }
+  Bytes bytes;
+};
+
+static Bytes withSize(const Bytes &data, size_t size)
+{
+  Bytes asset;
+  asset.push_back(size & 0xFF);
+  asset.push_back(size >> 8);
+  asset.insert(asset.end(), data.begin(), data.end());
+  return asset;
+}
+
+static Bytes packRLE(const Bytes &in)
+{
+  Bytes out;
+  size_t i = 0;
+  while (i < in.size()) {
+    size_t run = 1;
+    while (i + run < in.size() && in[i + run] == in[i] && run < 129)
+      run++;
+    if (run >= 2) {
+      out.push_back(0x80 | (run - 2));
+      out.push_back(in[i]);
+      i += run;
+      continue;
+    }
+    size_t start = i;
+    while (i < in.size() && i - start < 128 &&
+           !(i + 1 < in.size() && in[i + 1] == in[i]))
+      i++;
+    if (i == start)
+      i++;
+    out.push_back(i - start - 1);
+    out.insert(out.end(), in.begin() + start, in.begin() + i);
+  }
+  return withSize(out, in.size());
+}
+
+// Greedy longest match over the last 256 bytes, overlaps allowed.
+static Bytes packLZ(const Bytes &in)
+{
+  Bytes out;
+  size_t flagAt = 0;
+  uint8_t items = 8;
+  size_t i = 0;
+  while (i < in.size()) {
+    if (items == 8) {
+      flagAt = out.size();
+      out.push_back(0);
+      items = 0;
+    }
+    size_t best = 0, bestDistance = 0;
+    for (size_t d = 1; d <= 256 && d <= i; d++) {
+      size_t n = 0;
+      while (i + n < in.size() && n < 258 && in[i + n - d] == in[i + n])
+        n++;
+      if (n > best) {
+        best = n;
+        bestDistance = d;
+      }
+    }
+    if (best >= 3) {
+      out.push_back(bestDistance - 1);
+      out.push_back(best - 3);
+      i += best;
+    } else {
+      out[flagAt] |= 1 << items;
+      out.push_back(in[i++]);
+    }
+    items++;
+  }
+  return withSize(out, in.size());
+}
+
+// Literals, long runs, an overlapping match and a repeat exactly 256
+// bytes back.
+static Bytes sample()
+{
+  Bytes data;
+  for (int i = 0; i < 300; i++)
+    data.push_back((i * 37) ^ (i >> 3));
+  data.insert(data.end(), 200, 0x55);
+  data.insert(data.end(), data.end() - 256, data.end() - 200);
+  const char *text = "abcabcabcabcabcabcabcd";
+  data.insert(data.end(), text, text + strlen(text));
+  data.insert(data.end(), 3, 0x00);
+  data.push_back(0xFF);
+  return data;
+}
+
+template <class Decoder>
+static void checkDecoder(const Bytes &asset, const Bytes &expected)
+{
+  Decoder bytewise(&asset[0]);
+  CHECK_EQUAL(expected.size(), bytewise.remaining());
+  Bytes decoded;
+  while (bytewise.remaining())
+    decoded.push_back(bytewise.next());
+  CHECK(decoded == expected);
+  CHECK_EQUAL(0x00, bytewise.next());
+
+  Recorder device;
+  resetBus(CS_PIN, &device);
+  SPI.begin();
+  Decoder streamed(&asset[0]);
+  digitalWrite(CS_PIN, LOW);
+  CHECK_EQUAL(100, streamed.send(100));
+  CHECK_EQUAL(expected.size() - 100, streamed.send(0xFFFF));
+  CHECK_EQUAL(0, streamed.send(10));
+  digitalWrite(CS_PIN, HIGH);
+  CHECK(device.bytes == expected);
+}
+
+int main()
+{
+  Bytes data = sample();
+  Bytes rle = packRLE(data);
+  Bytes lz = packLZ(data);
+  CHECK(rle.size() < data.size());
+  CHECK(lz.size() < rle.size());
+
+  checkDecoder<SPIRLEDecoder>(rle, data);
+  checkDecoder<SPILZDecoder>(lz, data);
+  return TEST_RESULT();
+}
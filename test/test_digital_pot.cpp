@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// The DigitalPotControl example, unchanged, against the AD5206 model.
+
+#include "SPI.h"
+#include "spi_emu_devices.h"
+#include "test.h"
+
+// The IDE generates this prototype for the sketch.
+void digitalPotWrite(int address, int value);
+
+#include "../examples/DigitalPotControl/DigitalPotControl.ino"
+
+int main()
+{
+  SPIEmuDigitalPot pot;
+  resetBus(slaveSelectPin, &pot);
+
+  setup();
+  SPIEmulator::startTrace();
+  digitalPotWrite(2, 0x5A);
+  digitalPotWrite(5, 0xFF);
+  digitalPotWrite(6, 0x11);  // no such channel: ignored by the part
+  SPIEmulator::stopTrace();
+
+  CHECK_EQUAL(0x5A, pot.wiper(2));
+  CHECK_EQUAL(0xFF, pot.wiper(5));
+  CHECK_EQUAL(0x80, pot.wiper(0));
+  CHECK_EQUAL(2, pot.updates());
+  CHECK_EQUAL(3, SPIEmulator::transactions());
+  CHECK_POLLED_TIMING();
+
+  // One sweep of every channel up and back down leaves each at 1.
+  loop();
+  for (uint8_t channel = 0; channel < 6; channel++)
+    CHECK_EQUAL(1, pot.wiper(channel));
+  CHECK_EQUAL(2 + 6 * 2 * 255, pot.updates());
+  return TEST_RESULT();
+}
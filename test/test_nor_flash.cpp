@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// SPIFlashReader against the NOR flash model: cached, read-ahead,
+// continuous and streamed reads, and a page program that has to wait
+// out WIP before it reads back.
+
+#include "spi_flash.h"
+#include "spi_emu_devices.h"
+#include "test.h"
+
+#define CS_PIN 8
+#define FLASH_SIZE 65536UL
+#define LINE SPI_FLASH_LINE_SIZE
+
+static byte pattern(uint32_t addr)
+{
+  return (addr * 7) ^ (addr >> 8);
+}
+
+static void setUp(SPIEmuNorFlash &flash)
+{
+  resetBus(CS_PIN, &flash);
+  for (uint32_t i = 0; i < FLASH_SIZE; i++)
+    flash.memory()[i] = pattern(i);
+  SPI.begin();
+  SPI.setClockDivider(SPI_CLOCK_DIV2);
+}
+
+static void checkCachedReads()
+{
+  SPIEmuNorFlash flash(FLASH_SIZE);
+  setUp(flash);
+  SPIFlashReader reader(CS_PIN);
+  reader.begin();
+
+  // A first miss on line 0 is not mistaken for a sequential one.
+  SPIEmulator::startTrace();
+  CHECK_EQUAL(pattern(5), reader[5]);
+  CHECK_EQUAL(pattern(LINE - 1), reader[LINE - 1]);
+  CHECK_EQUAL(1, SPIEmulator::transactions());
+
+  // The second miss in a row is sequential: the lines after it come
+  // along under the same command, and reading them is free.
+  CHECK_EQUAL(pattern(LINE + 3), reader[LINE + 3]);
+  CHECK_EQUAL(2, SPIEmulator::transactions());
+  for (uint32_t addr = 2 * LINE; addr < (2 + SPI_FLASH_READAHEAD) * LINE; addr++)
+    CHECK_EQUAL(pattern(addr), reader[addr]);
+  CHECK_EQUAL(2, SPIEmulator::transactions());
+  CHECK_EQUAL(HIGH, digitalRead(CS_PIN));
+
+  // Two lines or more go straight to the caller in one command.
+  byte buf[100];
+  reader.read(40000, buf, sizeof(buf));
+  CHECK_EQUAL(3, SPIEmulator::transactions());
+  bool same = true;
+  for (size_t i = 0; i < sizeof(buf); i++)
+    same = same && buf[i] == pattern(40000 + i);
+  CHECK(same);
+
+  // A read that straddles two lines.
+  byte pair[4];
+  reader.read(20 * LINE - 2, pair, sizeof(pair));
+  CHECK_EQUAL(pattern(20 * LINE - 2), pair[0]);
+  CHECK_EQUAL(pattern(20 * LINE + 1), pair[3]);
+  SPIEmulator::stopTrace();
+  CHECK_POLLED_TIMING();
+}
+
+static void checkContinuous()
+{
+  SPIEmuNorFlash flash(FLASH_SIZE);
+  setUp(flash);
+  SPIFlashReader reader(CS_PIN);
+  reader.begin();
+  reader.setContinuous(true);
+
+  SPIEmulator::startTrace();
+  bool same = true;
+  for (uint32_t addr = 0; addr < 64 * LINE; addr++)
+    same = same && reader[addr] == pattern(addr);
+  CHECK(same);
+  CHECK_EQUAL(LOW, digitalRead(CS_PIN));
+  reader.release();
+  CHECK_EQUAL(HIGH, digitalRead(CS_PIN));
+  // One READ command for the whole sequential scan.
+  CHECK_EQUAL(1, SPIEmulator::transactions());
+
+  // A jump backwards needs a new command.
+  reader.invalidate();
+  CHECK_EQUAL(pattern(7 * LINE), reader[7 * LINE]);
+  CHECK_EQUAL(pattern(3), reader[3]);
+  reader.setContinuous(false);
+  SPIEmulator::stopTrace();
+  CHECK_EQUAL(HIGH, digitalRead(CS_PIN));
+  CHECK_EQUAL(3, SPIEmulator::transactions());
+}
+
+static byte command(byte opcode)
+{
+  digitalWrite(CS_PIN, LOW);
+  SPI.transfer(opcode);
+  byte out = SPI.transfer(0x00);
+  digitalWrite(CS_PIN, HIGH);
+  return out;
+}
+
+static void checkProgramAndStatus()
+{
+  SPIEmuNorFlash flash(FLASH_SIZE, 0xEF4018);
+  setUp(flash);
+  flash.setBusyCycles(20000, 400000);
+  SPIFlashReader reader(CS_PIN);
+  reader.begin();
+
+  digitalWrite(CS_PIN, LOW);
+  SPI.transfer(0x9F);
+  byte id[3];
+  SPI.transfer(NULL, id, sizeof(id));
+  digitalWrite(CS_PIN, HIGH);
+  CHECK_EQUAL(0xEF, id[0]);
+  CHECK_EQUAL(0x18, id[2]);
+
+  // Sector erase, then program one page into it.
+  CHECK_EQUAL(0x00, command(0x05));
+  command(0x06);
+  CHECK_EQUAL(0x02, command(0x05));  // WEL
+  byte erase[4] = { 0x20, 0x00, 0x10, 0x00 };
+  digitalWrite(CS_PIN, LOW);
+  SPI.transfer(erase, NULL, sizeof(erase));
+  digitalWrite(CS_PIN, HIGH);
+  uint32_t polls = 0;
+  while (command(0x05) & 0x01)
+    polls++;
+  CHECK(polls > 0);
+
+  command(0x06);
+  byte page[4 + 32] = { 0x02, 0x00, 0x10, 0x00 };
+  for (uint8_t i = 0; i < 32; i++)
+    page[4 + i] = 0xA0 + i;
+  digitalWrite(CS_PIN, LOW);
+  SPI.transfer(page, NULL, sizeof(page));
+  digitalWrite(CS_PIN, HIGH);
+
+  // While WIP is set the array does not answer reads.
+  CHECK_EQUAL(0x01, command(0x05));
+  CHECK_EQUAL(0xFF, reader[0x1000]);
+  polls = 0;
+  while (command(0x05) & 0x01)
+    polls++;
+  CHECK(polls > 0);
+
+  reader.invalidate();
+  CHECK_EQUAL(0xA0, reader[0x1000]);
+  CHECK_EQUAL(0xBF, reader[0x101F]);
+  CHECK_EQUAL(0xFF, reader[0x1020]);  // erased, not programmed
+  CHECK_EQUAL(pattern(0x2000), reader[0x2000]);  // outside the sector
+}
+
+// Random single-byte reads over a working set that fits the cache stay
+// off the bus; a long streamed read runs close to the wire rate.
+static void checkThroughput()
+{
+  SPIEmuNorFlash flash(FLASH_SIZE);
+  setUp(flash);
+  SPIFlashReader reader(CS_PIN);
+  reader.begin();
+
+  uint32_t seed = 1;
+  bool same = true;
+  SPIEmulator::startTrace();
+  uint64_t start = SPIEmulator::cycles();
+  for (uint32_t i = 0; i < 100000; i++) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t addr = (seed >> 8) & 0x7F;
+    same = same && reader[addr] == pattern(addr);
+  }
+  uint64_t cycles = SPIEmulator::cycles() - start;
+  SPIEmulator::stopTrace();
+  CHECK(same);
+  CHECK(SPIEmulator::transactions() < 100);
+  CHECK(cycles < 100000ULL * 8);
+
+  static byte block[4096];
+  start = SPIEmulator::cycles();
+  reader.read(8192, block, sizeof(block));
+  cycles = SPIEmulator::cycles() - start;
+  CHECK_EQUAL(pattern(8192 + 4095), block[4095]);
+  // 16 cycles a byte on the wire at DIV2.
+  CHECK(cycles < sizeof(block) * 20);
+}
+
+int main()
+{
+  checkCachedReads();
+  checkContinuous();
+  checkProgramAndStatus();
+  checkThroughput();
+  return TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// The profiler's histograms and utilization on the emulated clock,
+// reported directly and through SPIDevice. Built with SPI_PROFILING.
+
+#include "spi_device.h"
+#include "spi_profiler.h"
+#include "test.h"
+
+#define CS_PIN 9
+
+class Sink : public SPIEmuDevice {
+public:
+  virtual byte exchange(byte) { return 0x00; }
+};
+
+// Index of the only non-empty bucket, or -1.
+static int onlyBucket(const SPIHistogram &histogram)
+{
+  int found = -1;
+  for (uint8_t i = 0; i < SPI_PROFILER_BUCKETS; i++) {
+    if (!histogram.bucket[i])
+      continue;
+    if (found >= 0)
+      return -1;
+    found = i;
+  }
+  return found;
+}
+
+static void checkHistograms()
+{
+  SPIEmulator::reset();
+  SPIProfiler::reset();
+
+  // Requested at micros() == 0, which must still count.
+  SPIProfiler::requested(0);
+  delayMicroseconds(100);
+  SPIProfiler::selected(0);
+  delayMicroseconds(50);
+  SPIProfiler::deselected(0, 4);
+  delayMicroseconds(300);
+  SPIProfiler::selected(1);
+  delayMicroseconds(20);
+  SPIProfiler::deselected(1, 1);
+
+  const SPIDeviceProfile &first = SPIProfiler::device(0);
+  CHECK_EQUAL(1, first.wait.bucket[7]);   // 100us in [64, 128)
+  CHECK_EQUAL(7, onlyBucket(first.wait));
+  CHECK_EQUAL(6, onlyBucket(first.hold));  // 50us in [32, 64)
+  CHECK_EQUAL(3, onlyBucket(first.bytes)); // 4 in [4, 8)
+
+  // No requested() for the second device: no wait sample.
+  const SPIDeviceProfile &second = SPIProfiler::device(1);
+  CHECK_EQUAL(-1, onlyBucket(second.wait));
+  CHECK_EQUAL(5, onlyBucket(second.hold));
+  CHECK_EQUAL(1, onlyBucket(second.bytes));
+  CHECK_EQUAL(9, onlyBucket(SPIProfiler::idleGaps()));  // 300us
+
+  byte report[512];
+  size_t length = SPIProfiler::serialize(report, sizeof(report));
+  CHECK_EQUAL(3 + (3 * SPI_PROFILER_DEVICES + 1) * 2 * SPI_PROFILER_BUCKETS + 1, length);
+  CHECK_EQUAL(SPI_PROFILER_FORMAT, report[0]);
+  CHECK_EQUAL(SPI_PROFILER_DEVICES, report[1]);
+  CHECK_EQUAL(0, SPIProfiler::serialize(report, length - 1));
+}
+
+// Busy half of the time for a second, through SPIDevice.
+static void checkUtilization()
+{
+  Sink sink;
+  resetBus(CS_PIN, &sink);
+  SPIProfiler::reset();
+  SPI.begin();
+  SPIDevice device(CS_PIN, SPISettings(SPI_CLOCK_DIV4, MSBFIRST, SPI_MODE0));
+  device.begin();
+
+  byte data[8] = { 0 };
+  for (int i = 0; i < 2000; i++) {
+    device.select();
+    device.transfer(data, NULL, sizeof(data));
+    delayMicroseconds(250 - 16);
+    device.deselect();
+    delayMicroseconds(250);
+  }
+  uint8_t percent = SPIProfiler::utilization();
+  CHECK(percent >= 48 && percent <= 52);
+  CHECK_EQUAL(2000, SPIProfiler::device(device.id()).bytes.bucket[4]);
+  CHECK_EQUAL(2000 - 1, SPIProfiler::idleGaps().bucket[8]);
+}
+
+int main()
+{
+  checkHistograms();
+  checkUtilization();
+  return TEST_RESULT();
+}
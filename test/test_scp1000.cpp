@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// The BarometricPressureSensor example, unchanged, against the SCP1000
+// model.
+
+#include "SPI.h"
+#include "spi_emu_devices.h"
+#include "test.h"
+
+// The IDE generates these prototypes for a sketch.
+unsigned int readRegister(byte thisRegister, int bytesToRead);
+void writeRegister(byte thisRegister, byte thisValue);
+
+#include "../examples/BarometricPressureSensor/BarometricPressureSensor.ino"
+
+int main()
+{
+  SPIEmuSCP1000 sensor(dataReadyPin);
+  resetBus(chipSelectPin, &sensor);
+  SPIEmulator::startTrace();
+
+  setup();
+  CHECK_EQUAL(0x2D, sensor.getRegister(0x02));
+  CHECK_EQUAL(0x03, sensor.getRegister(0x01));
+  CHECK_EQUAL(0x02, sensor.getRegister(0x03));
+
+  // 25.5 degC and 101325 Pa in the part's units.
+  sensor.setSample(510, 101325UL * 4);
+  loop();
+  CHECK(Serial.output.find("Temp[C]=25.5") != std::string::npos);
+  CHECK(Serial.output.find("Pressure [Pa]=101325\n") != std::string::npos);
+  CHECK_EQUAL(LOW, digitalRead(dataReadyPin));
+
+  CHECK_EQUAL(510, readRegister(TEMPERATURE, 2));
+  CHECK_EQUAL(101325UL * 4 >> 16, readRegister(PRESSURE, 1));
+
+  SPIEmulator::stopTrace();
+  // setup() and loop() write four registers and read three.
+  CHECK_EQUAL(3 + 1 + 3 + 2, SPIEmulator::transactions());
+  CHECK_POLLED_TIMING();
+  return TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// SD card in SPI mode: the init handshake, a block write and read back,
+// and a run of block reads timed against the wire rate.
+
+#include "spi_emu_devices.h"
+#include "test.h"
+
+#define CS_PIN 4
+#define BLOCKS 64
+#define BLOCK 512
+
+static byte sdCommand(uint8_t cmd, uint32_t arg, byte crc = 0x01)
+{
+  byte frame[6] = {
+    (byte)(0x40 | cmd), (byte)(arg >> 24), (byte)(arg >> 16),
+    (byte)(arg >> 8), (byte)arg, crc
+  };
+  SPI.transfer(frame, NULL, sizeof(frame));
+  // R1 arrives within eight bytes, with the top bit clear.
+  byte r1 = 0xFF;
+  for (uint8_t i = 0; i < 8 && (r1 & 0x80); i++)
+    r1 = SPI.transfer(0xFF);
+  return r1;
+}
+
+static byte appCommand(uint8_t cmd, uint32_t arg)
+{
+  sdCommand(55, 0);
+  return sdCommand(cmd, arg);
+}
+
+static bool waitToken()
+{
+  for (uint16_t i = 0; i < 1000; i++) {
+    if (SPI.transfer(0xFF) == 0xFE)
+      return true;
+  }
+  return false;
+}
+
+static void readBlock(uint32_t block, byte *buf)
+{
+  digitalWrite(CS_PIN, LOW);
+  CHECK_EQUAL(0x00, sdCommand(17, block));
+  CHECK(waitToken());
+  SPI.transfer(NULL, buf, BLOCK, 0xFF);
+  SPI.transfer(0xFF);  // CRC
+  SPI.transfer(0xFF);
+  digitalWrite(CS_PIN, HIGH);
+}
+
+static void checkInit()
+{
+  // 80 clocks with CS high put the card in SPI mode.
+  digitalWrite(CS_PIN, HIGH);
+  for (uint8_t i = 0; i < 10; i++)
+    SPI.transfer(0xFF);
+
+  digitalWrite(CS_PIN, LOW);
+  CHECK_EQUAL(0x01, sdCommand(0, 0, 0x95));
+
+  CHECK_EQUAL(0x01, sdCommand(8, 0x1AA, 0x87));
+  byte r7[4];
+  SPI.transfer(NULL, r7, sizeof(r7), 0xFF);
+  CHECK_EQUAL(0x01, r7[2]);
+  CHECK_EQUAL(0xAA, r7[3]);
+
+  // A block read before init completes is refused.
+  CHECK((sdCommand(17, 0) & 0x40) != 0);
+
+  uint8_t polls = 1;
+  while (appCommand(41, 0x40000000) != 0x00 && polls < 100)
+    polls++;
+  CHECK_EQUAL(3, polls);
+
+  CHECK_EQUAL(0x00, sdCommand(58, 0));
+  byte ocr[4];
+  SPI.transfer(NULL, ocr, sizeof(ocr), 0xFF);
+  CHECK_EQUAL(0xC0, ocr[0]);  // powered up, high capacity
+  digitalWrite(CS_PIN, HIGH);
+  SPI.transfer(0xFF);
+}
+
+static void checkWriteRead(SPIEmuSDCard &card)
+{
+  byte block[BLOCK];
+  for (uint16_t i = 0; i < BLOCK; i++)
+    block[i] = i ^ 0x5A;
+
+  digitalWrite(CS_PIN, LOW);
+  CHECK_EQUAL(0x00, sdCommand(24, 7));
+  SPI.transfer(0xFF);
+  SPI.transfer(0xFE);
+  SPI.transfer(block, NULL, sizeof(block));
+  SPI.transfer(0xFF);  // CRC
+  SPI.transfer(0xFF);
+  byte response = 0xFF;
+  for (uint8_t i = 0; i < 8 && response == 0xFF; i++)
+    response = SPI.transfer(0xFF);
+  CHECK_EQUAL(0x05, response & 0x1F);
+  uint16_t busy = 0;
+  while (SPI.transfer(0xFF) != 0xFF && busy < 1000)
+    busy++;
+  CHECK(busy < 1000);
+  digitalWrite(CS_PIN, HIGH);
+  CHECK_EQUAL(0x5A, card.memory()[7 * BLOCK]);
+  CHECK_EQUAL(0xFF ^ 0x5A, card.memory()[7 * BLOCK + 0xFF]);
+
+  byte back[BLOCK];
+  readBlock(7, back);
+  CHECK(memcmp(block, back, BLOCK) == 0);
+
+  // Out of range.
+  digitalWrite(CS_PIN, LOW);
+  CHECK((sdCommand(17, BLOCKS) & 0x40) != 0);
+  digitalWrite(CS_PIN, HIGH);
+}
+
+static void checkThroughput(SPIEmuSDCard &card)
+{
+  for (uint32_t i = 0; i < card.memory().size(); i++)
+    card.memory()[i] = i * 13;
+  SPI.setClockDivider(SPI_CLOCK_DIV2);
+
+  byte buf[BLOCK];
+  bool same = true;
+  uint64_t start = SPIEmulator::cycles();
+  for (uint16_t n = 0; n < 1000; n++) {
+    uint32_t block = n % BLOCKS;
+    readBlock(block, buf);
+    same = same && buf[0] == (byte)(block * BLOCK * 13) &&
+           buf[BLOCK - 1] == (byte)((block * BLOCK + BLOCK - 1) * 13);
+  }
+  uint64_t cycles = SPIEmulator::cycles() - start;
+  CHECK(same);
+  // 16 cycles a byte on the wire at DIV2; the command, token and CRC
+  // overhead has to stay small next to the 512 data bytes.
+  CHECK(cycles < 1000ULL * BLOCK * 20);
+}
+
+int main()
+{
+  SPIEmuSDCard card(BLOCKS);
+  resetBus(CS_PIN, &card);
+  SPI.begin();
+  SPI.setClockDivider(SPI_CLOCK_DIV64);  // under 400 kHz until init is done
+  checkInit();
+  checkWriteRead(card);
+  checkThroughput(card);
+  return TEST_RESULT();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// SPIClass::send() at the two dividers it schedules by cycle count: no
+// byte may collide, and the shifter may only idle for the margin the
+// schedule leaves.
+
+#include "spi.h"
+#include "test.h"
+
+#include <vector>
+
+#define CS_PIN 9
+
+class Recorder : public SPIEmuDevice {
+public:
+  virtual byte exchange(byte mosi) { bytes.push_back(mosi); return 0x00; }
+  std::vector<byte> bytes;
+};
+
+// period is SPI_TIMED_PERIOD_DIV2/DIV4 in spi_timed.cpp.
+static void checkSchedule(uint8_t divider, uint32_t byteCycles, uint32_t period)
+{
+  for (size_t count = 2; count <= 9; count++) {
+    Recorder device;
+    resetBus(CS_PIN, &device);
+    SPI.begin();
+    SPI.setClockDivider(divider);
+
+    byte data[9];
+    for (size_t i = 0; i < count; i++)
+      data[i] = 0xA0 + i;
+
+    SPIEmulator::startTrace();
+    digitalWrite(CS_PIN, LOW);
+    uint8_t result = SPI.send(data, count);
+    digitalWrite(CS_PIN, HIGH);
+    SPIEmulator::stopTrace();
+
+    CHECK_EQUAL(SPI_OK, result);
+    CHECK(!(SPSR & _BV(WCOL)));
+    CHECK_EQUAL(count, device.bytes.size());
+    CHECK(memcmp(data, &device.bytes[0], count) == 0);
+    CHECK_EQUAL(period - byteCycles, SPIEmulator::maxByteGap());
+  }
+}
+
+int main()
+{
+  checkSchedule(SPI_CLOCK_DIV2, 8 * 2, 18);
+  checkSchedule(SPI_CLOCK_DIV4, 8 * 4, 34);
+  return TEST_RESULT();
+}
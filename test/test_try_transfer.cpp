@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 by the SPI library contributors.
+ * SPI Master library for arduino.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+// Bounded-wait transfers: a timeout leaves the bus ready for a retry,
+// and a write into a busy shifter is reported rather than read back.
+
+#include "spi.h"
+#include "test.h"
+
+#define CS_PIN 9
+
+// Answers each byte with the one before it, inverted.
+class Echo : public SPIEmuDevice {
+public:
+  Echo() : last(0x00) {}
+  virtual byte exchange(byte mosi) { byte out = ~last; last = mosi; return out; }
+  byte last;
+};
+
+int main()
+{
+  Echo device;
+  resetBus(CS_PIN, &device);
+  SPI.begin();
+  SPI.setClockDivider(SPI_CLOCK_DIV128);
+  digitalWrite(CS_PIN, LOW);
+
+  byte in = 0;
+  CHECK_EQUAL(SPI_OK, SPI.tryTransfer(0x11, &in));
+  CHECK_EQUAL(0xFF, in);
+
+  // One poll is far too short at DIV128; the retry must not collide
+  // with the late byte or return its data.
+  CHECK_EQUAL(SPI_ERR_TIMEOUT, SPI.tryTransfer(0x22, &in, 1));
+  in = 0;
+  CHECK_EQUAL(SPI_OK, SPI.tryTransfer(0x33, &in));
+  CHECK_EQUAL((byte)~0x22, in);
+
+  // A byte started behind tryTransfer()'s back is still shifting.
+  SPDR = 0x44;
+  CHECK_EQUAL(SPI_ERR_COLLISION, SPI.tryTransfer(0x55, &in));
+  CHECK_EQUAL(0x44, device.last);
+
+  byte out[3] = { 1, 2, 3 }, back[3];
+  CHECK_EQUAL(SPI_OK, SPI.tryTransfer(out, back, sizeof(out)));
+  CHECK_EQUAL((byte)~0x44, back[0]);
+  CHECK_EQUAL((byte)~2, back[2]);
+
+  CHECK_EQUAL(SPI_ERR_TIMEOUT, SPI.tryTransfer(0x66, &in, 0));
+  digitalWrite(CS_PIN, HIGH);
+  return TEST_RESULT();
+}